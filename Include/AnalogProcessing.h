@@ -0,0 +1,189 @@
+#pragma once
+
+#include "Common.h"
+
+namespace libgameinput
+{
+	struct InputProperties;
+	enum class InputValueFunction;
+
+	/// How to turn a raw analog value into a processed one; by default, taken from the input's properties
+	struct AnalogChannelSettings
+	{
+		/// In raw units; values between these are treated as neutral
+		double DeadZoneMin = 0;
+		double DeadZoneMax = 0;
+
+		/// In raw units; the processed value is -1 at MinValue, 0 at NeutralValue and 1 at MaxValue (before the response curve and sensitivity)
+		double MinValue = -1;
+		double NeutralValue = 0;
+		double MaxValue = 1;
+
+		InputValueFunction ValueFunction{};
+		bool Inverted = false;
+		double Sensitivity = 1;
+
+		static auto FromProperties(InputProperties const& props) -> AnalogChannelSettings;
+	};
+
+	/// Runs deadzone, range normalization, response curve, inversion and sensitivity over many analog channels at once.
+	/// Channel parameters are stored as a structure-of-arrays and the chain is run with SIMD kernels, where available.
+	struct AnalogProcessor
+	{
+		auto AddChannel(AnalogChannelSettings const& settings) -> size_t;
+		void Configure(size_t channel, AnalogChannelSettings const& settings);
+		void Clear();
+
+		size_t ChannelCount() const { return mChannelCount; }
+
+		/// Fill these before calling `Process()`
+		auto RawValues() -> std::span<float> { return { mRaw.data(), mChannelCount }; }
+		auto Results() const -> std::span<float const> { return { mResult.data(), mChannelCount }; }
+
+		void Process();
+		/// Only reprocesses the lanes holding these channels, which should be sorted; other results keep their values
+		void Process(std::span<uint32_t const> channels);
+
+	private:
+
+		/// All arrays are padded to a multiple of this, so the kernels never need a scalar tail
+		static constexpr size_t Lanes = 8;
+
+		void ProcessLanes(size_t begin, size_t end);
+
+		size_t mChannelCount = 0;
+
+		std::vector<float> mRaw;
+		std::vector<float> mPositiveOrigin;
+		std::vector<float> mPositiveScale;
+		std::vector<float> mNegativeOrigin;
+		std::vector<float> mNegativeScale;
+		/// Response curve: y = x * (Linear + |x| * (Quadratic + |x| * Cubic)); sensitivity and inversion are folded into the coefficients
+		std::vector<float> mLinear;
+		std::vector<float> mQuadratic;
+		std::vector<float> mCubic;
+		std::vector<float> mResult;
+	};
+
+	enum class StickDeadZoneType
+	{
+		/// Each axis has its own deadzone; snaps to cardinal directions, but makes diagonals hard to hit
+		Axial,
+		/// The stick is neutral within a circle, and raw outside it; there is a jump in value at the edge
+		Radial,
+		/// Like Radial, but the magnitude is rescaled from the edge of the deadzone, so there is no jump
+		ScaledRadial,
+		/// ScaledRadial followed by a sloped axial deadzone, so that cardinal directions are easy to hold without losing diagonals
+		Hybrid,
+	};
+
+	/// All values are in processed stick units, i.e. 1 is full deflection
+	struct StickDeadZoneSettings
+	{
+		StickDeadZoneType Type = StickDeadZoneType::ScaledRadial;
+		double InnerDeadZone = 0.15;
+		/// Deflection beyond this is treated as full deflection; hardware rarely reaches 1 along diagonals
+		double OuterDeadZone = 0.95;
+		/// The smallest magnitude reported outside the deadzone; counteracts deadzones that games apply on top of ours
+		double AntiDeadZone = 0;
+	};
+
+	/// Runs two-axis deadzones over many sticks at once; like AnalogProcessor, parameters are stored as a structure-of-arrays.
+	struct StickProcessor
+	{
+		auto AddStick(StickDeadZoneSettings const& settings) -> size_t;
+		void Configure(size_t stick, StickDeadZoneSettings const& settings);
+		void Clear();
+
+		size_t StickCount() const { return mStickCount; }
+
+		/// Fill these before calling `Process()`
+		auto RawX() -> std::span<float> { return { mRawX.data(), mStickCount }; }
+		auto RawY() -> std::span<float> { return { mRawY.data(), mStickCount }; }
+		auto ResultX() const -> std::span<float const> { return { mResultX.data(), mStickCount }; }
+		auto ResultY() const -> std::span<float const> { return { mResultY.data(), mStickCount }; }
+
+		void Process();
+		/// Like `AnalogProcessor::Process(channels)`
+		void Process(std::span<uint32_t const> sticks);
+
+	private:
+
+		static constexpr size_t Lanes = 4;
+
+		void ProcessLanes(size_t begin, size_t end);
+
+		size_t mStickCount = 0;
+
+		std::vector<float> mRawX;
+		std::vector<float> mRawY;
+		std::vector<float> mInner;
+		std::vector<float> mInverseRange; /// 1 / (Outer - Inner)
+		std::vector<float> mOuter;
+		std::vector<float> mAnti;
+		/// The deadzone type is stored as blend weights, so that sticks with different types can share a kernel
+		std::vector<float> mAxialWeight;
+		std::vector<float> mScaledWeight;
+		std::vector<float> mSlope;
+		std::vector<float> mResultX;
+		std::vector<float> mResultY;
+	};
+
+	/// See "1€ Filter: A Simple Speed-based Low-pass Filter for Noisy Input in Interactive Systems" (Casiez et al.)
+	/// Lowering `MinCutoff` removes more jitter when still; raising `Beta` removes more lag when moving.
+	struct OneEuroFilterSettings
+	{
+		double MinCutoff = 1.0; /// Hz
+		double Beta = 0.007;
+		double DerivativeCutoff = 1.0; /// Hz
+	};
+
+	template <typename T>
+	struct OneEuroFilter
+	{
+		OneEuroFilterSettings Settings;
+
+		/// `dt` is the time since the previous sample, in seconds
+		auto Filter(T const& value, double dt) -> T const&
+		{
+			if (!mInitialized || !(dt > 0))
+			{
+				if (!mInitialized)
+					mValue = value;
+				mInitialized = true;
+				return mValue;
+			}
+
+			const auto derivative = (value - mValue) / dt;
+			mDerivative += (derivative - mDerivative) * Alpha(Settings.DerivativeCutoff, dt);
+			const auto cutoff = Settings.MinCutoff + Settings.Beta * Magnitude(mDerivative);
+			mValue += (value - mValue) * Alpha(cutoff, dt);
+			return mValue;
+		}
+
+		void Reset() { mValue = {}; mDerivative = {}; mInitialized = false; }
+
+		auto Value() const -> T const& { return mValue; }
+		bool HasValue() const { return mInitialized; }
+
+	private:
+
+		T mValue{};
+		T mDerivative{};
+		bool mInitialized = false;
+
+		static auto Alpha(double cutoff, double dt) -> double
+		{
+			const auto tau = 1.0 / (2.0 * 3.14159265358979323846 * cutoff);
+			return 1.0 / (1.0 + tau / dt);
+		}
+
+		static auto Magnitude(T const& value) -> double
+		{
+			if constexpr (std::is_arithmetic_v<T>)
+				return std::abs(double(value));
+			else
+				return glm::length(value);
+		}
+	};
+}
@@ -1,29 +1,209 @@
 #include "Common.h"
 
+#include <bit>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define LIBGAMEINPUT_RAYS_AVX 1
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIBGAMEINPUT_RAYS_SSE2 1
+#endif
+
 namespace libgameinput
 {
-    /// Per "Closest point between two rays" by http://palitri.com
+#if defined(LIBGAMEINPUT_RAYS_AVX) || defined(LIBGAMEINPUT_RAYS_SSE2)
+    /// Overloads for the ray kernel, so that it is written once for both register widths
+    template <typename V> static auto Set(double value) -> V;
+    template <typename V, size_t Width> static auto Gather(std::array<ViewRay const*, Width> const& rays, vec3 ViewRay::* member, int axis) -> V;
+
+    template <> auto Set<__m128d>(double value) -> __m128d { return _mm_set1_pd(value); }
+    template <> auto Gather<__m128d, 2>(std::array<ViewRay const*, 2> const& rays, vec3 ViewRay::* member, int axis) -> __m128d
+    {
+        return _mm_set_pd((&(rays[1]->*member).x)[axis], (&(rays[0]->*member).x)[axis]);
+    }
+    static void Store(double (&to)[2], __m128d v) { _mm_storeu_pd(to, v); }
+    static auto Add(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+    static auto Sub(__m128d a, __m128d b) { return _mm_sub_pd(a, b); }
+    static auto Mul(__m128d a, __m128d b) { return _mm_mul_pd(a, b); }
+    static auto Div(__m128d a, __m128d b) { return _mm_div_pd(a, b); }
+    static auto And(__m128d a, __m128d b) { return _mm_and_pd(a, b); }
+    static auto Greater(__m128d a, __m128d b) { return _mm_cmpgt_pd(a, b); }
+
+#if defined(LIBGAMEINPUT_RAYS_AVX)
+    template <> auto Set<__m256d>(double value) -> __m256d { return _mm256_set1_pd(value); }
+    template <> auto Gather<__m256d, 4>(std::array<ViewRay const*, 4> const& rays, vec3 ViewRay::* member, int axis) -> __m256d
+    {
+        return _mm256_set_pd((&(rays[3]->*member).x)[axis], (&(rays[2]->*member).x)[axis], (&(rays[1]->*member).x)[axis], (&(rays[0]->*member).x)[axis]);
+    }
+    static void Store(double (&to)[4], __m256d v) { _mm256_storeu_pd(to, v); }
+    static auto Add(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+    static auto Sub(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+    static auto Mul(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+    static auto Div(__m256d a, __m256d b) { return _mm256_div_pd(a, b); }
+    static auto And(__m256d a, __m256d b) { return _mm256_and_pd(a, b); }
+    static auto Greater(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+#endif
+#endif
+
+    /// sin^2 of the angle between the rays, below which they are treated as parallel
+    static constexpr double ParallelRaysEpsilon = 1e-12;
+
+    /// Per "Closest point between two rays" by http://palitri.com; the directions do not need to be normalized
     vec3 ClosestPointBetween(ViewRay const& ray1, ViewRay const& ray2)
     {
-        const auto a = normalize(ray1.Direction);
-        const auto b = normalize(ray2.Direction);
-        const auto c = ray2.Position - ray2.Position;
+        const auto a = ray1.Direction;
+        const auto b = ray2.Direction;
+        const auto c = ray2.Position - ray1.Position;
         const auto A = ray1.Position;
         const auto B = ray2.Position;
         const auto aa = dot(a, a);
         const auto bb = dot(b, b);
         const auto ab = dot(a, b);
-        const auto denom = (aa * bb - ab * ab);
-        
-        if (aa == 0 || bb == 0 || denom == 0) /// consistency check; TODO: approximize
+        const auto denom = aa * bb - ab * ab;
+
+        /// denom / (aa * bb) is sin^2 of the angle between the rays
+        if (!(aa > 0) || !(bb > 0) || !(denom > ParallelRaysEpsilon * aa * bb))
             return (A + B) * 0.5;
 
         const auto ac = dot(a, c);
         const auto bc = dot(b, c);
-        const auto alpha_a = (-(ab * bc) + (ac * bb)) / denom;
+        const auto alpha_a = (ac * bb - ab * bc) / denom;
         const auto alpha_b = (ab * ac - bc * aa) / denom;
         const auto D = A + a * alpha_a;
         const auto E = B + b * alpha_b;
         return (D + E) * 0.5;
     }
-}
\ No newline at end of file
+
+#if defined(LIBGAMEINPUT_RAYS_AVX) || defined(LIBGAMEINPUT_RAYS_SSE2)
+    /// Same as above, for as many rays as fit in a register; the vectors are filled straight from the rays, rather than
+    /// through memory, to avoid store forwarding stalls. Degenerate lanes get zero alphas, so they also end up halfway between the origins.
+    template <typename V, size_t Width = sizeof(V) / sizeof(double)>
+    static void ClosestPointsKernel(std::array<ViewRay const*, Width> const& rays1, std::array<ViewRay const*, Width> const& rays2, double (&out)[3][Width])
+    {
+        const auto zero = Set<V>(0.0);
+        V a[3], b[3], A[3], B[3];
+        auto aa = zero, bb = zero, ab = zero, ac = zero, bc = zero;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            a[axis] = Gather<V>(rays1, &ViewRay::Direction, axis);
+            b[axis] = Gather<V>(rays2, &ViewRay::Direction, axis);
+            A[axis] = Gather<V>(rays1, &ViewRay::Position, axis);
+            B[axis] = Gather<V>(rays2, &ViewRay::Position, axis);
+            const auto c = Sub(B[axis], A[axis]);
+            aa = Add(aa, Mul(a[axis], a[axis]));
+            bb = Add(bb, Mul(b[axis], b[axis]));
+            ab = Add(ab, Mul(a[axis], b[axis]));
+            ac = Add(ac, Mul(a[axis], c));
+            bc = Add(bc, Mul(b[axis], c));
+        }
+        const auto aabb = Mul(aa, bb);
+        const auto denom = Sub(aabb, Mul(ab, ab));
+        /// The comparisons are false for NaNs too, like the negated ones above
+        const auto valid = And(And(Greater(aa, zero), Greater(bb, zero)), Greater(denom, Mul(Set<V>(ParallelRaysEpsilon), aabb)));
+        const auto inv_denom = And(valid, Div(Set<V>(1.0), denom));
+        const auto alpha_a = Mul(Sub(Mul(ac, bb), Mul(ab, bc)), inv_denom);
+        const auto alpha_b = Mul(Sub(Mul(ab, ac), Mul(bc, aa)), inv_denom);
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const auto sum = Add(Add(A[axis], B[axis]), Add(Mul(a[axis], alpha_a), Mul(b[axis], alpha_b)));
+            Store(out[axis], Mul(sum, Set<V>(0.5)));
+        }
+    }
+#endif
+
+    /// Same as above, run through SIMD kernels, where available
+    void ClosestPointBetween(std::span<ViewRay const> rays1, std::span<ViewRay const> rays2, std::span<vec3> results)
+    {
+        const auto count = std::min({ rays1.size(), rays2.size(), results.size() });
+
+#if defined(LIBGAMEINPUT_RAYS_AVX) || defined(LIBGAMEINPUT_RAYS_SSE2)
+#if defined(LIBGAMEINPUT_RAYS_AVX)
+        using V = __m256d;
+#else
+        using V = __m128d;
+#endif
+        constexpr size_t Width = sizeof(V) / sizeof(double);
+        for (size_t base = 0; base < count; base += Width)
+        {
+            const auto lanes = std::min(Width, count - base);
+
+            /// Lanes past the end repeat the last ray, and are not stored
+            std::array<ViewRay const*, Width> lane_rays1, lane_rays2;
+            for (size_t lane = 0; lane < Width; ++lane)
+            {
+                const auto index = base + std::min(lane, lanes - 1);
+                lane_rays1[lane] = &rays1[index];
+                lane_rays2[lane] = &rays2[index];
+            }
+
+            double out[3][Width];
+            ClosestPointsKernel<V>(lane_rays1, lane_rays2, out);
+            for (size_t lane = 0; lane < lanes; ++lane)
+                results[base + lane] = { out[0][lane], out[1][lane], out[2][lane] };
+        }
+#else
+        for (size_t i = 0; i < count; ++i)
+            results[i] = ClosestPointBetween(rays1[i], rays2[i]);
+#endif
+    }
+
+    auto DoubleToU32(double v) -> uint32_t
+    {
+        return std::bit_cast<uint32_t>(float(v));
+    }
+
+    auto U32ToDouble(uint32_t v) -> double
+    {
+        return std::bit_cast<float>(v);
+    }
+
+    auto Vec2ToU64(vec2 const& v) -> uint64_t
+    {
+        return uint64_t(DoubleToU32(v.x)) | (uint64_t(DoubleToU32(v.y)) << 32);
+    }
+
+    auto U64ToVec2(uint64_t v) -> vec2
+    {
+        return { U32ToDouble(uint32_t(v)), U32ToDouble(uint32_t(v >> 32)) };
+    }
+
+    static constexpr int PackedDoubleBits = 42;
+    static constexpr int PackedDoubleDroppedBits = 64 - PackedDoubleBits;
+    static constexpr uint64_t PackedDoubleMask = (uint64_t(1) << PackedDoubleBits) - 1;
+
+    static auto DoubleToU42(double v) -> uint64_t
+    {
+        const auto bits = std::bit_cast<uint64_t>(v);
+        const auto exponent_bits = bits & 0x7FF0'0000'0000'0000ull;
+        /// Round to nearest, unless that would carry into the exponent of an infinity or NaN
+        if (exponent_bits == 0x7FF0'0000'0000'0000ull)
+            return (bits >> PackedDoubleDroppedBits) | ((bits & 0x000F'FFFF'FFFF'FFFFull) ? 1 : 0);
+        const auto rounded = bits + (uint64_t(1) << (PackedDoubleDroppedBits - 1));
+        if ((rounded & 0x7FF0'0000'0000'0000ull) == 0x7FF0'0000'0000'0000ull)
+            return bits >> PackedDoubleDroppedBits;
+        return (rounded >> PackedDoubleDroppedBits) & PackedDoubleMask;
+    }
+
+    static auto U42ToDouble(uint64_t v) -> double
+    {
+        return std::bit_cast<double>((v & PackedDoubleMask) << PackedDoubleDroppedBits);
+    }
+
+    auto Vec3ToU128(vec3 const& v) -> uint128_t
+    {
+        const auto x = DoubleToU42(v.x), y = DoubleToU42(v.y), z = DoubleToU42(v.z);
+        /// x: bits 0-41, y: bits 42-83, z: bits 84-125
+        return { x | (y << 42), (y >> 22) | (z << 20) };
+    }
+
+    auto U128ToVec3(uint128_t v) -> vec3
+    {
+        const auto x = v[0];
+        const auto y = (v[0] >> 42) | (v[1] << 22);
+        const auto z = v[1] >> 20;
+        return { U42ToDouble(x), U42ToDouble(y), U42ToDouble(z) };
+    }
+}
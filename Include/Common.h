@@ -51,13 +51,20 @@ namespace libgameinput
 		vec3 Direction{}; 
 	};
 
+	/// Parallel rays and rays without a direction have no single closest point; for them, this returns the point halfway between their origins
 	vec3 ClosestPointBetween(ViewRay const& ray1, ViewRay const& ray2);
+	/// Batch version, e.g. for many users or replays; processes as many rays as the shortest span holds, with the same results as above
+	void ClosestPointBetween(std::span<ViewRay const> rays1, std::span<ViewRay const> rays2, std::span<vec3> results);
 
+	/// Lossy packings of values for storage and transmission:
+	/// - doubles packed into 32 bits are stored as floats
+	/// - vec2s are two floats
+	/// - vec3s are three doubles rounded to 42 bits each (sign, full exponent, 30 bits of mantissa; ~9 significant digits)
 	using uint128_t = std::array<uint64_t, 2>;
 	auto Vec3ToU128(vec3 const& v) -> uint128_t;
 	auto U128ToVec3(uint128_t v) -> vec3;
 	auto Vec2ToU64(vec2 const& v) -> uint64_t;
-	auto U64ToVec2(uint64_t v) -> vec3;
+	auto U64ToVec2(uint64_t v) -> vec2;
 	auto DoubleToU32(double v) -> uint32_t;
 	auto U32ToDouble(uint32_t v) -> double;
 }
\ No newline at end of file
@@ -3,6 +3,11 @@
 #include "Common.h"
 #include <format>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <source_location>
+#include <utility>
 
 namespace libgameinput
 {
@@ -16,6 +21,7 @@ namespace libgameinput
 	};
 
 	struct IErrorReporter;
+	struct StructuredReport;
 
 	struct Reporter
 	{
@@ -50,9 +56,127 @@ namespace libgameinput
 		void Perform();
 	};
 
+	/// A report that captures its values without allocating: numbers are stored as they are, string literals as views, 
+	/// and other strings are copied into a fixed inline buffer (and truncated if it runs out). Nothing is formatted until
+	/// a reporter actually performs it, so code on hot paths can report freely; reporters that are not interested in a
+	/// report type (see `IErrorReporter::WantsReport`) never pay for formatting at all.
+	struct StructuredReport
+	{
+		static constexpr size_t MaxValues = 8;
+		static constexpr size_t InlineTextCapacity = 128;
+
+		enum class ValueKind : uint8_t
+		{
+			Bool,
+			Signed,
+			Unsigned,
+			Float,
+			Pointer,
+			StaticText,
+			InlineText,
+		};
+
+		struct ReportValue
+		{
+			std::string_view Name; /// must be static text
+			ValueKind Kind = ValueKind::Bool;
+			union
+			{
+				bool Bool;
+				int64_t Signed;
+				uint64_t Unsigned;
+				double Float;
+				void const* Pointer;
+				std::string_view StaticText;
+				struct { uint16_t Offset; uint16_t Size; } InlineText;
+			};
+
+			ReportValue() noexcept : Unsigned(0) {}
+		};
+
+		IErrorReporter const* Target = nullptr;
+		ReportType Type = ReportType::Error;
+		std::string_view Message; /// must be static text
+		std::source_location Location;
+		std::array<ReportValue, MaxValues> Values;
+		uint8_t ValueCount = 0;
+		uint16_t InlineTextSize = 0;
+		bool Truncated = false; /// values or text did not fit
+		std::array<char, InlineTextCapacity> InlineText;
+
+		/// Character arrays are assumed to be string literals, and are not copied
+		template <size_t N>
+		StructuredReport& Value(std::string_view name, char const (&static_text)[N]) noexcept { if (auto value = NewValue(name, ValueKind::StaticText)) value->StaticText = std::string_view{ static_text }; return *this; }
+		StructuredReport& Value(std::string_view name, std::string_view text) noexcept;
+		StructuredReport& Value(std::string_view name, std::string const& text) noexcept { return Value(name, std::string_view{ text }); }
+		StructuredReport& Value(std::string_view name, bool value) noexcept { if (auto v = NewValue(name, ValueKind::Bool)) v->Bool = value; return *this; }
+		StructuredReport& Value(std::string_view name, void const* value) noexcept { if (auto v = NewValue(name, ValueKind::Pointer)) v->Pointer = value; return *this; }
+		template <typename T>
+		requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+		StructuredReport& Value(std::string_view name, T value) noexcept
+		{
+			if constexpr (std::is_enum_v<T>)
+				return Value(name, static_cast<std::underlying_type_t<T>>(value));
+			else if constexpr (std::is_floating_point_v<T>)
+			{
+				if (auto v = NewValue(name, ValueKind::Float)) v->Float = (double)value;
+			}
+			else if constexpr (std::is_signed_v<T>)
+			{
+				if (auto v = NewValue(name, ValueKind::Signed)) v->Signed = (int64_t)value;
+			}
+			else if (auto v = NewValue(name, ValueKind::Unsigned)) 
+				v->Unsigned = (uint64_t)value;
+			return *this;
+		}
+
+		auto ValueText(ReportValue const& value) const -> std::string_view;
+		/// Formats the value; this is where allocation happens, if the report is performed at all
+		auto FormatValue(ReportValue const& value) const -> std::string;
+		/// Builds a regular report, with the values formatted
+		auto ToReporter() const -> Reporter;
+
+		void Perform() const;
+
+	private:
+
+		auto NewValue(std::string_view name, ValueKind kind) noexcept -> ReportValue*;
+	};
+	static_assert(std::is_trivially_copyable_v<StructuredReport>);
+
+	/// A call site of a rate-limited report; declare it as a function-local static, so that it is identified by where it is declared.
+	/// Reports from the same site are deduplicated: after one is reported, further occurrences are only counted until 
+	/// `MinInterval` passes, and the next report says how many there were in between.
+	struct ReportSite
+	{
+		ReportSite(ReportType type, std::string_view message, std::chrono::milliseconds min_interval = std::chrono::seconds{ 1 }, std::source_location location = std::source_location::current()) noexcept
+			: Type(type), Message(message), MinInterval(min_interval), Location(location)
+		{
+		}
+
+		ReportSite(ReportSite const&) = delete;
+		ReportSite& operator=(ReportSite const&) = delete;
+
+		ReportType const Type;
+		std::string_view const Message; /// must outlive the site, like a string literal
+		std::chrono::milliseconds const MinInterval;
+		std::source_location const Location;
+
+		auto Occurrences() const noexcept -> uint64_t { return mOccurrences.load(std::memory_order_relaxed); }
+
+	private:
+
+		friend struct IErrorReporter;
+
+		std::atomic<uint64_t> mOccurrences = 0;
+		std::atomic<bool> mArmed = true; /// only a hint that a report may be due; reports are claimed through mNextReportTime
+		std::atomic<int64_t> mNextReportTime = 0; /// steady_clock ticks
+		std::atomic<uint64_t> mReportedOccurrences = 0;
+	};
+
 	struct IErrorReporter
 	{
-		virtual ~IErrorReporter() = default;
+		virtual ~IErrorReporter();
 
 		template <typename... ARGS>
 		Reporter NewError(std::string_view fmt, ARGS&&... args) const
@@ -70,6 +194,16 @@ namespace libgameinput
 			return result;
 		}
 
+		auto NewStructuredReport(ReportType type, std::string_view static_message, std::source_location location = std::source_location::current()) const noexcept -> StructuredReport
+		{
+			StructuredReport result;
+			result.Target = this;
+			result.Type = type;
+			result.Message = static_message;
+			result.Location = location;
+			return result;
+		}
+
 		template <typename... ARGS>
 		void Error(std::string_view fmt, ARGS&&... args) const
 		{
@@ -88,11 +222,72 @@ namespace libgameinput
 			throw NewError(fmt, std::forward<ARGS>(args)...);
 		}
 
+		/// Reports from a rate-limited site, with additional info given as name/value pairs: 
+		/// `Report(site, "PlayerID", player, "ActionID", action)`.
+		/// Suppressed occurrences only increment a counter; the values are captured (see `StructuredReport`) only when a report is due.
+		template <typename... NAME_VALUE_PAIRS>
+		void Report(ReportSite& site, NAME_VALUE_PAIRS const&... name_value_pairs) const
+		{
+			static_assert(sizeof...(NAME_VALUE_PAIRS) % 2 == 0, "additional info must be given as name/value pairs");
+
+			const auto occurrence = site.mOccurrences.fetch_add(1, std::memory_order_relaxed) + 1;
+			/// In deferred mode, the background thread arms sites once they are due, so suppressed occurrences do not even read the clock
+			if (!site.mArmed.load(std::memory_order_relaxed) && mDeferredReporting.load(std::memory_order_relaxed))
+				return;
+			if (!ClaimSiteReport(site))
+				return;
+
+			auto report = NewStructuredReport(site.Type, site.Message, site.Location);
+			const auto args = std::forward_as_tuple(name_value_pairs...);
+			[&]<size_t... I>(std::index_sequence<I...>) {
+				(report.Value(std::get<I * 2>(args), std::get<I * 2 + 1>(args)), ...);
+			}(std::make_index_sequence<sizeof...(NAME_VALUE_PAIRS) / 2>{});
+			SubmitSiteReport(site, occurrence, report);
+		}
+
+		/// In deferred mode, `Report(site, ...)` only queues the report (lock-free); a background thread builds, formats and 
+		/// performs it, and re-arms sites once their interval passes. Other reports are still performed immediately.
+		/// Reporters that override `PerformReport` should stop deferred reporting in their destructor.
+		/// Sites are remembered by the reporter, so they must outlive it (function-local statics do).
+		void StartDeferredReporting(std::chrono::milliseconds poll_interval = std::chrono::milliseconds{ 50 });
+		/// Performs the reports still in the queue, and joins the background thread
+		void StopDeferredReporting();
+		bool IsReportingDeferred() const noexcept { return mDeferredReporting.load(std::memory_order_relaxed); }
+
 		virtual void PerformReport(Reporter const& holder) const;
 
+		/// Return false for report types that should be ignored, e.g. infos and warnings in release builds; 
+		/// only checked for structured reports, before anything is formatted
+		virtual bool WantsReport(ReportType type) const { return true; }
+		/// Override to consume structured reports without formatting them (e.g. to write them to a binary log);
+		/// by default, they are formatted and passed to `PerformReport`
+		virtual void PerformStructuredReport(StructuredReport const& report) const;
+
 	protected:
 
 		mutable std::mutex mMutex;
+
+		struct PendingReport
+		{
+			PendingReport* Next = nullptr;
+			ReportSite* Site = nullptr;
+			uint64_t Occurrence = 0;
+			StructuredReport Report;
+		};
+
+		mutable std::atomic<PendingReport*> mPendingReports = nullptr; /// a lock-free stack, newest first
+		std::atomic<bool> mDeferredReporting = false;
+		std::thread mDeferredThread;
+		mutable std::mutex mDeferredMutex;
+		std::condition_variable mDeferredWake;
+		bool mStopDeferred = false;
+		mutable std::vector<ReportSite*> mSites; /// every site reported so far, so the background thread can re-arm them; guarded by mDeferredMutex
+
+		bool ClaimSiteReport(ReportSite& site) const noexcept;
+		void SubmitSiteReport(ReportSite& site, uint64_t occurrence, StructuredReport const& report) const;
+		void PerformSiteReport(ReportSite& site, uint64_t occurrence, StructuredReport const& report) const;
+		void PerformPendingReports();
+		void RearmDueSites();
 		/*
 		struct Report
 		{
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Common.h"
+#include "InputDevice.h"
+
+#include <map>
+#include <set>
+#include <unordered_map>
+
+namespace libgameinput
+{
+	/// Finds the next widget to focus in a direction, for directional UI navigation. Widgets are added as rectangles (in any
+	/// space where y grows downwards, like `UINavigationInputToDirection` assumes) and bucketed into a uniform grid, so moving a
+	/// widget only touches the cells it leaves and enters, and a query only visits the rings of cells around the focused
+	/// widget until nothing closer than the best candidate can be left.
+	///
+	/// A candidate must lie ahead of the focused rectangle, and is scored by its distance from it, plus `MisalignmentWeight`
+	/// times how far its center is off to the side, unless it overlaps the focused widget's row or column; ties go to the one
+	/// closest to the focused widget's center line.
+	///
+	/// Queries are not thread-safe, even though they are const.
+	struct FocusNavigator
+	{
+		/// `cell_size` should be about the size of a typical widget
+		explicit FocusNavigator(double cell_size = 64.0);
+
+		double MisalignmentWeight = 2.0; /// should be 1 or more
+
+		auto Add(rec2 const& rect) -> size_t;
+		void Move(size_t widget, rec2 const& rect);
+		void Remove(size_t widget);
+		/// Disabled widgets stay in the index, but are never returned
+		void SetEnabled(size_t widget, bool enabled);
+		void Clear();
+		/// Rebuckets all widgets, e.g. when the layout was rescaled
+		void SetCellSize(double cell_size);
+
+		auto Rect(size_t widget) const -> rec2 const*;
+		auto Count() const -> size_t { return mCount; }
+
+		/// Returns InvalidIndex if there is no widget in that direction
+		auto FindNext(rec2 const& from, vec2 direction, size_t exclude = InvalidIndex) const -> size_t;
+		/// Moves by as many steps as the length of the input's direction, e.g. 10 for `PageDown`, and as far as it goes for
+		/// `Home` and `End`; returns `from` if it cannot move, and InvalidIndex for inputs without a direction
+		auto FindNext(size_t from, UINavigationInput input) const -> size_t;
+
+	private:
+
+		struct Widget
+		{
+			rec2 Rect{};
+			bool Alive = false;
+			bool Enabled = true;
+			int32_t Cells[4]{}; /// x1, y1, x2, y2 of the cells it covers
+		};
+
+		static auto CellKey(int32_t x, int32_t y) -> uint64_t { return (uint64_t(uint32_t(x)) << 32) | uint32_t(y); }
+		auto CellOf(double coordinate) const -> int32_t;
+		void Insert(uint32_t widget);
+		void Erase(uint32_t widget);
+		void InsertExtents(rec2 const& rect);
+		void EraseExtents(rec2 const& rect);
+		void UpdateBounds();
+		/// The first ring after `ring` that has an occupied cell, or -1 if none does
+		auto NextOccupiedRing(int32_t const (&origin)[4], int32_t ring) const -> int32_t;
+		bool AheadCovered(int32_t const (&origin)[4], int32_t rings, rec2 const& from, vec2 direction) const;
+		/// Returns the number of widgets seen for the first time in this query
+		auto ScanCell(int32_t x, int32_t y, rec2 const& from, vec2 direction, size_t exclude, size_t& best, double& best_score, double& best_offset) const -> size_t;
+
+		double mCellSize;
+		std::vector<Widget> mWidgets;
+		std::vector<uint32_t> mFreeWidgets;
+		std::unordered_map<uint64_t, std::vector<uint32_t>> mCells;
+		size_t mCount = 0;
+		/// Occupied cells per row and column, so queries can skip empty rings, and stop when no occupied cells are left
+		std::map<int32_t, uint32_t> mRows;
+		std::map<int32_t, uint32_t> mColumns;
+		/// Edges of all widgets, so the bounds shrink when the outermost widget moves in or is removed
+		std::multiset<double> mLeftEdges, mTopEdges, mRightEdges, mBottomEdges;
+		int32_t mBounds[4]{ 0, 0, -1, -1 }; /// of the occupied cells
+		rec2 mContentBounds{}; /// of the widgets
+
+		mutable std::vector<uint32_t> mVisited; /// [widget] query stamp, so widgets in several cells are scored once
+		mutable uint32_t mQuery = 0;
+	};
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "InputDevice.h"
+
+namespace libgameinput
+{
+	enum class GestureType
+	{
+		Tap,
+		DoubleTap,
+		Hold,
+		SwipeLeft,
+		SwipeRight,
+		SwipeUp,
+		SwipeDown,
+		Rotate, /// two pointers twisting around each other
+		Circle, /// a closed circular stroke, in either direction; built in, so it needs no template
+		Template, /// a stroke that matched one of the templates added with `AddTemplate`
+	};
+
+	struct GestureEvent
+	{
+		GestureType Type = GestureType::Tap;
+		size_t Pointer = 0;
+		size_t Template = InvalidIndex;
+		TimePoint Time{};
+		vec2 Position{}; /// where the gesture started
+		vec2 Direction{}; /// for swipes, normalized
+		double Angle = 0; /// for rotations, the twist since the previous rotate event; for circles, 2 pi or -2 pi; in radians, clockwise on screen
+		double Score = 1; /// for templates, the cosine similarity to the template (1 is a perfect match)
+	};
+
+	/// Distances are in the units of the pointer positions (usually pixels)
+	struct GestureSettings
+	{
+		double TapSlop = 12; /// moving further than this makes a touch a stroke, rather than a tap or hold
+		Seconds TapMaxDuration{ 0.3 };
+		Seconds DoubleTapMaxInterval{ 0.35 };
+		Seconds HoldMinDuration{ 0.6 };
+
+		double SwipeMinDistance = 60;
+		Seconds SwipeMaxDuration{ 0.5 };
+		double SwipeMinStraightness = 0.85; /// distance from start to end divided by the path length
+
+		double RotateMinAngle = 0.25; /// in radians; two pointers must twist this far before rotating is recognized
+
+		double ResampleSpacing = 6; /// strokes are resampled as they are drawn, into points this far apart
+		double MinTemplateScore = 0.85;
+		bool RecognizeCircles = true;
+	};
+
+	/// Recognizes gestures incrementally from timestamped pointer (mouse, pen or touch) samples:
+	/// - taps, double taps and holds, by per-pointer state machines
+	/// - swipes, by the straightness and speed of the stroke
+	/// - rotations, by the change in angle of the line between the first two pointers down
+	/// - circles, and arbitrary strokes (checkmarks, letters), by matching them to templates with the Protractor variant of the $1 recognizer
+	///
+	/// Every sample costs O(1): strokes are resampled to evenly spaced points online, into fixed per-pointer buffers
+	/// (halving the resolution when a buffer fills up), and templates are matched once, when the stroke ends, against
+	/// a bounded number of points. Nothing is allocated after the templates are added, unless more events than
+	/// ever before are produced between two `ClearEvents` calls.
+	struct GestureRecognizer
+	{
+		static constexpr size_t MaxPointers = 16;
+		static constexpr size_t MaxStrokePoints = 128;
+		static constexpr size_t TemplatePoints = 32;
+
+		GestureSettings Settings;
+
+		/// Points are in any units; strokes are matched regardless of their size and position.
+		/// Rotation invariant templates also match rotated strokes (e.g. a circle started anywhere).
+		auto AddTemplate(std::string name, std::span<vec2 const> points, bool rotation_invariant = false) -> size_t;
+		auto TemplateCount() const -> size_t { return mTemplates.size(); }
+		auto TemplateName(size_t index) const -> std::string_view { return index < mTemplates.size() ? std::string_view{ mTemplates[index].Name } : std::string_view{}; }
+
+		/// Pointer ids are arbitrary (e.g. touch ids from the OS); at most `MaxPointers` can be down at once
+		void PointerDown(size_t pointer, vec2 position, TimePoint time);
+		void PointerMoved(size_t pointer, vec2 position, TimePoint time);
+		void PointerUp(size_t pointer, vec2 position, TimePoint time);
+		/// Forgets the pointer without recognizing anything, e.g. when the OS cancels a touch
+		void PointerCancelled(size_t pointer);
+		/// Holds are recognized by time, so this should be called every frame, even if no samples arrive
+		void Update(TimePoint now);
+
+		/// Events recognized since the last `ClearEvents`, in order
+		auto Events() const -> std::span<GestureEvent const> { return mEvents; }
+		void ClearEvents() { mEvents.clear(); }
+
+	private:
+
+		struct PointerState
+		{
+			bool Active = false;
+			bool Moved = false;
+			bool HoldRecognized = false;
+			bool Twisted = false; /// part of a recognized rotation, so not a stroke of its own
+			size_t ID = 0;
+			TimePoint DownTime{};
+			vec2 DownPosition{};
+			vec2 LastPosition{};
+			double PathLength = 0;
+			double Spacing = 0; /// the current resampling spacing; doubles every time the buffer fills up
+			double DistanceSinceResample = 0;
+			size_t PointCount = 0;
+			std::array<vec2, MaxStrokePoints> Points{};
+		};
+
+		struct StrokeTemplate
+		{
+			std::string Name;
+			bool RotationInvariant = false;
+			std::array<vec2, TemplatePoints> Vector{}; /// centered, rotated if rotation invariant, and normalized to unit length
+		};
+
+		std::array<PointerState, MaxPointers> mPointers{};
+		std::vector<StrokeTemplate> mTemplates;
+		std::vector<GestureEvent> mEvents;
+		TimePoint mLastTapTime{};
+		vec2 mLastTapPosition{};
+		bool mLastTapValid = false;
+
+		struct TwistState
+		{
+			PointerState* Pointers[2]{};
+			vec2 Center{}; /// between the pointers, when the second went down
+			double LastAngle = 0;
+			double Accumulated = 0; /// since the last rotate event
+			bool Recognized = false;
+		};
+		TwistState mTwist;
+
+		auto FindPointer(size_t pointer) -> PointerState*;
+		void AddStrokePoint(PointerState& state, vec2 point);
+		void EndStroke(PointerState& state, TimePoint time);
+		void MatchTemplates(PointerState const& state, TimePoint time);
+		void UpdateTwist(TimePoint time);
+
+		static bool Vectorize(std::span<vec2 const> points, bool rotation_invariant, std::array<vec2, TemplatePoints>& into);
+	};
+
+	/// Exposes recognized gestures as inputs, so that they can be mapped like buttons: every `GestureType` (except `Template`)
+	/// is an input, followed by one input per template. An input reads as pressed for the rest of the frame in which its
+	/// gesture was recognized; the details of every gesture (where, which pointer) are in `FrameEvents`.
+	/// Templates should be added before the device is added to the input system. Holds are recognized by time, so `Update`
+	/// should be called every frame, with a time from the same clock as the pointer samples.
+	struct GestureDevice : public virtual IInputDevice
+	{
+		static constexpr size_t FirstTemplateInput = size_t(GestureType::Template);
+
+		GestureDevice(IInputSystem& sys);
+
+		GestureRecognizer Recognizer;
+
+		/// Returns the input the template is recognized as
+		auto AddTemplate(std::string name, std::span<vec2 const> points, bool rotation_invariant = false, std::string glyph_uri = {}) -> size_t;
+
+		void PointerDown(size_t pointer, vec2 position, TimePoint time) { Recognizer.PointerDown(pointer, position, time); CollectEvents(); }
+		void PointerMoved(size_t pointer, vec2 position, TimePoint time) { Recognizer.PointerMoved(pointer, position, time); CollectEvents(); }
+		void PointerUp(size_t pointer, vec2 position, TimePoint time) { Recognizer.PointerUp(pointer, position, time); CollectEvents(); }
+		void PointerCancelled(size_t pointer) { Recognizer.PointerCancelled(pointer); }
+		void Update(TimePoint now) { Recognizer.Update(now); CollectEvents(); }
+
+		/// Gestures recognized this frame
+		auto FrameEvents() const -> std::span<GestureEvent const> { return mFrameEvents; }
+
+		virtual enum_flags<InputDeviceFlags> Flags() const override { return {}; }
+		virtual auto ValidInputs() const -> std::span<InputProperties const> override { return mInputProperties; }
+		virtual bool IsAnyInputActive() const override;
+		virtual double InputValue(size_t input) const override { return input < mCurrent.size() ? mCurrent[input] : 0.0; }
+		virtual double InputValueLastFrame(size_t input) const override { return input < mLast.size() ? mLast[input] : 0.0; }
+		virtual bool CanTriggerNavigation(UINavigationInput input) const override { return false; }
+		virtual bool IsNavigationPressed(UINavigationInput input) const override { return false; }
+		virtual bool WasNavigationPressedLastFrame(UINavigationInput input) const override { return false; }
+		virtual bool IsStringPropertyValid(StringProperty property) const override { return property == StringProperty::Name; }
+		virtual std::string_view StringPropertyValue(StringProperty property, std::string_view lang = {}) const override { return property == StringProperty::Name ? "Gestures" : ""; }
+		virtual void ForceRefresh() override {}
+		virtual void NewFrame() override;
+
+	private:
+
+		std::vector<InputProperties> mInputProperties;
+		std::vector<double> mCurrent;
+		std::vector<double> mLast;
+		std::vector<GestureEvent> mFrameEvents;
+
+		void CollectEvents();
+	};
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Common.h"
+
+#include <unordered_map>
+#include <optional>
+
+namespace libgameinput
+{
+	struct InputProperties;
+	struct IInputDevice;
+
+	/// A glyph's place in an atlas, in pixels
+	struct GlyphAtlasRect
+	{
+		uint16_t Page = 0;
+		uint16_t X = 0;
+		uint16_t Y = 0;
+		uint16_t Width = 0;
+		uint16_t Height = 0;
+	};
+
+	struct GlyphAtlasPage
+	{
+		/// The directory the glyphs on this page come from, e.g. "ControllerGraphics/Xbox One" or "ControllerGraphics/Keyboard & Mouse/Dark";
+		/// glyphs of different controller families and themes never share a page
+		std::string Group;
+		uint16_t Width = 0;
+		uint16_t Height = 0;
+	};
+
+	/// An index of glyph URIs to atlas rects. The atlas itself does not hold any pixel data - the images are blitted into pages
+	/// by the user, using the rects returned from the builder, so that any renderer or image library can be used.
+	struct GlyphAtlas
+	{
+		GlyphAtlas() = default;
+		/// Bound tables point into the atlas they were bound to, so copies start unbound
+		GlyphAtlas(GlyphAtlas const& other) : mPages(other.mPages), mRects(other.mRects) {}
+		GlyphAtlas(GlyphAtlas&&) noexcept = default;
+		GlyphAtlas& operator=(GlyphAtlas const& other) { mPages = other.mPages; mRects = other.mRects; mBoundTables.clear(); return *this; }
+		GlyphAtlas& operator=(GlyphAtlas&&) noexcept = default;
+
+		auto Pages() const -> std::span<GlyphAtlasPage const> { return mPages; }
+
+		/// Returns nullptr if the glyph is not in the atlas
+		auto Find(std::string_view glyph_uri) const -> GlyphAtlasRect const*;
+
+		/// Returns the rect of the primary (first) glyph of the input; this parses and looks up its glyph URI.
+		auto RectFor(InputProperties const& input) const -> GlyphAtlasRect const*;
+		/// For devices whose property tables are bound, this is an indexed load; other inputs fall back to the URI lookup
+		auto RectFor(IInputDevice const& device, size_t input) const -> GlyphAtlasRect const*;
+
+		/// Resolves the rects of every input of the devices' property tables up front, so that prompts do no string work.
+		/// Call again when devices are connected or disconnected; `IInputSystem::SetGlyphAtlas` does this for its atlas.
+		/// Not thread-safe with respect to `RectFor`.
+		void BindDevices(std::span<std::unique_ptr<IInputDevice> const> devices);
+
+		auto Serialize() const -> std::vector<uint8_t>;
+		static auto Deserialize(std::span<uint8_t const> data) -> std::optional<GlyphAtlas>;
+
+	private:
+
+		friend struct GlyphAtlasBuilder;
+
+		struct StringHash
+		{
+			using is_transparent = void;
+			size_t operator()(std::string_view str) const noexcept { return std::hash<std::string_view>{}(str); }
+		};
+
+		std::vector<GlyphAtlasPage> mPages;
+		std::unordered_map<std::string, GlyphAtlasRect, StringHash, std::equal_to<>> mRects;
+
+		/// Devices of the same type usually share a table, so there are only a few of these
+		struct BoundTable
+		{
+			std::span<InputProperties const> Inputs;
+			std::vector<GlyphAtlasRect const*> Rects; /// [input]
+		};
+		std::vector<BoundTable> mBoundTables;
+	};
+
+	/// Packs glyphs into pages, one set of pages per controller family and theme (i.e. per glyph directory)
+	struct GlyphAtlasBuilder
+	{
+		void Add(std::string_view glyph_uri, uint16_t width, uint16_t height);
+
+		/// Glyphs larger than the page size get a page of their own
+		/// `blit` is called once per glyph, so the user can copy the image into the page
+		auto Build(uint16_t page_size = 1024, uint16_t padding = 1, std::function<void(std::string_view, GlyphAtlasRect const&)> blit = {}) const -> GlyphAtlas;
+
+	private:
+
+		struct Glyph
+		{
+			std::string URI;
+			uint16_t Width = 0;
+			uint16_t Height = 0;
+		};
+
+		std::vector<Glyph> mGlyphs;
+	};
+
+	/// Returns the first URI in a newline separated list of glyph URIs, as stored in InputDeviceComponentProperties::GlyphURIs
+	auto PrimaryGlyphURI(std::string_view glyph_uris) -> std::string_view;
+}
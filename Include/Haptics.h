@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Common.h"
+#include "OutputScheduler.h"
+
+#include <atomic>
+
+namespace libgameinput
+{
+	struct IInputDevice;
+
+	struct HapticCurvePoint
+	{
+		Seconds Time{};
+		double Amplitude = 0; /// 0-1
+	};
+
+	struct HapticEffectDescription
+	{
+		/// Amplitude over time, interpolated linearly; the effect ends at the last point
+		std::vector<HapticCurvePoint> Envelope;
+		/// Of the sine the envelope modulates on waveform outputs; 0 plays the envelope itself, e.g. for sharp clicks
+		double Frequency = 160.0;
+		/// How much of the amplitude goes to the low and high frequency motors of devices without waveform outputs
+		vec2 Motors{ 1.0, 0.0 };
+		bool Loop = false;
+
+		/// Rises to 1 over `attack`, falls to `sustain_level` over `decay`, stays there for `sustain` and fades out over `release`
+		static auto ADSR(Seconds attack, Seconds decay, double sustain_level, Seconds sustain, Seconds release) -> HapticEffectDescription;
+	};
+
+	using HapticVoice = uint64_t;
+	static constexpr HapticVoice NoHapticVoice = 0;
+
+	/// Plays haptic effects on devices. Effects are compiled into sample tables when they are loaded, so playing them
+	/// only reads and adds table entries: every `Update`, the voices playing on each device are mixed into a fixed
+	/// buffer and sent to its waveform output (see `OutputFlags::Waveform`), either pushed through `SendOutputData`, or
+	/// through a ring buffer the device pulls from, if it takes a `SetOutputCallback`. Devices that only have plain
+	/// vibration outputs get the mixed envelope amplitudes instead, split between their motors, posted to an
+	/// `OutputScheduler`, so they blend with other rumble and are only written when they change.
+	///
+	/// Nothing allocates after the effects are loaded; voices and devices are kept in fixed arrays, and `Play` fails when
+	/// they are full. `Update` should be called every frame, before the scheduler is flushed.
+	struct HapticsEngine
+	{
+		static constexpr size_t MaxVoices = 32;
+		static constexpr size_t MaxDevices = 8;
+		/// Samples mixed per device per update; at 3 kHz, this covers about a third of a second
+		static constexpr size_t MaxChunk = 1024;
+		static constexpr size_t RingSize = 2048; /// must be a power of two
+
+		explicit HapticsEngine(OutputScheduler& fallback_outputs, double sample_rate = 3000.0);
+		~HapticsEngine();
+		HapticsEngine(HapticsEngine const&) = delete;
+		HapticsEngine& operator=(HapticsEngine const&) = delete;
+
+		/// For the amplitudes posted to vibration outputs
+		int FallbackPriority = 0;
+		OutputBlend FallbackBlend = OutputBlend::Max;
+
+		/// Returns the effect's index; loading allocates, playing does not
+		auto LoadEffect(HapticEffectDescription const& description) -> size_t;
+		auto EffectDuration(size_t effect) const -> Seconds;
+
+		/// Returns `NoHapticVoice` if the device has no vibration outputs, or there are no free voices or device slots
+		auto Play(IInputDevice& device, size_t effect, double gain = 1.0) -> HapticVoice;
+		void Stop(HapticVoice voice);
+		void SetGain(HapticVoice voice, double gain);
+		bool IsPlaying(HapticVoice voice) const;
+		/// Stops the voices of one device, or of all if null
+		void StopAll(IInputDevice const* device = nullptr);
+		/// Must be called before the device is destroyed, e.g. from `IInputSystem::InputDevicesChanged` handling
+		void RemoveDevice(IInputDevice const* device);
+
+		void Update(TimePoint now);
+
+	private:
+
+		struct Effect
+		{
+			size_t Offset = 0; /// in the sample pools
+			size_t Length = 0;
+			vec2 Motors{};
+			bool Loop = false;
+		};
+
+		struct Voice
+		{
+			uint32_t Generation = 0;
+			uint32_t Stream = 0; /// the device's slot
+			size_t Effect = InvalidIndex; /// InvalidIndex if free
+			double Position = 0; /// in samples of the effect's tables
+			float Gain = 1;
+		};
+
+		/// Filled by `Update`, drained by the device's output callback, possibly on another thread
+		struct SampleRing
+		{
+			std::array<int8_t, RingSize> Samples{};
+			std::atomic<uint32_t> Read = 0;
+			std::atomic<uint32_t> Write = 0;
+
+			auto Free() const -> size_t { return RingSize - (Write.load(std::memory_order_relaxed) - Read.load(std::memory_order_acquire)); }
+			void Push(std::span<int8_t const> samples);
+			void Pull(std::span<uint8_t> into);
+		};
+
+		struct DeviceStream
+		{
+			IInputDevice* Device = nullptr; /// null if the slot is free
+			size_t Output = InvalidIndex;
+			bool Waveform = false;
+			bool Pulled = false; /// through the ring
+			double SampleRate = 0;
+			double PendingSamples = 0; /// fraction of a sample carried to the next update
+			size_t Voices = 0;
+			SampleRing Ring;
+		};
+
+		auto VoiceOf(HapticVoice voice) -> Voice*;
+		auto VoiceOf(HapticVoice voice) const -> Voice const*;
+		auto StreamOf(IInputDevice& device) -> DeviceStream*;
+		void FreeVoice(Voice& voice);
+		void MixWaveform(DeviceStream& stream, uint32_t stream_index, double elapsed);
+		void MixAmplitude(DeviceStream& stream, uint32_t stream_index);
+
+		OutputScheduler& mFallbackOutputs;
+		double mSampleRate;
+		std::vector<Effect> mEffects;
+		std::vector<float> mWaveformPool; /// envelope times carrier
+		std::vector<float> mEnvelopePool;
+		std::array<Voice, MaxVoices> mVoices{};
+		std::array<DeviceStream, MaxDevices> mStreams{};
+		std::array<float, MaxChunk> mMix{};
+		std::array<int8_t, MaxChunk> mChunk{};
+		TimePoint mLastUpdate{};
+	};
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Common.h"
+#include "PoseHistory.h"
+#include "MouseMotion.h"
+#include "AnalogProcessing.h"
 
 namespace libgameinput
 {
@@ -49,6 +52,15 @@ namespace libgameinput
 		uintptr_t InternalID = {};
 	};
 
+	/// The response curve applied to an analog input, after deadzone and normalization
+	enum class InputValueFunction
+	{
+		Linear,
+		Quadratic, /// x * |x|
+		Cubic, /// x^3
+		SCurve, /// 1.5x - 0.5x^3; a polynomial approximation of a sinusoidal curve
+	};
+
 	struct InputProperties : InputDeviceComponentProperties
 	{
 		enum_flags<InputFlags> Flags{};
@@ -72,8 +84,9 @@ namespace libgameinput
 		std::string Dimension;
 		vec3 RepresentsDirection = {};
 
+		InputValueFunction ValueFunction = InputValueFunction::Linear;
+
 		/// TODO: InputControlType -> enum { PushButton, MomentaryTrigger, Switch, Hat, Slider, Dial, Wheel, };
-		/// TODO: ValueFunction -> enum { Linear, Quadratic, Sinusoidal, etc. }
 	};
 
 	struct ButtonInputProperties : InputProperties
@@ -109,11 +122,15 @@ namespace libgameinput
 		Continuous, /// vs triggered requests
 		CanBeDisabled,
 		Notification, /// e.g. for one-of events or alarms
+		/// Vibration outputs that play sample buffers (signed 8-bit, one sample every `UpdateFrequency`) sent through 
+		/// `SendOutputData`, or pulled through `SetOutputCallback`, rather than taking an amplitude through `SetOutput`
+		Waveform,
 	};
 
 	struct OutputProperties : InputDeviceComponentProperties
 	{
 		InputDeviceOutputType Type = InputDeviceOutputType::Other;
+		enum_flags<OutputFlags> Flags{};
 
 		vec3 Resolution = { 1,1,1 };
 
@@ -161,9 +178,19 @@ namespace libgameinput
 		PageUp, PageDown, PageLeft, PageRight,
 		ScrollUp, ScrollDown, ScrollLeft, ScrollRight,
 	};
+	static constexpr size_t UINavigationInputCount = size_t(UINavigationInput::ScrollRight) + 1;
 
 	vec2 UINavigationInputToDirection(UINavigationInput input);
 
+	/// A device input that triggers a navigation input when `Direction * value` reaches `PressThreshold`
+	struct NavigationBinding
+	{
+		UINavigationInput Navigation{};
+		size_t Input = InvalidIndex;
+		float Direction = 1; /// -1 for the negative direction of an axis
+		float PressThreshold = std::numeric_limits<float>::quiet_NaN(); /// NaN means "use the input's PressedThreshold"
+	};
+
 	enum class BodySide
 	{
 		Left,
@@ -196,8 +223,10 @@ namespace libgameinput
 		virtual std::string_view Name() const;
 		virtual enum_flags<InputDeviceFlags> Flags() const = 0;
 
+		/// NOTE: Implementations should return a span over a table that is built once (per device model, or per device on connection)
+		/// and stays immutable afterwards, so that property queries never allocate
 		virtual auto ValidInputs() const -> std::span<InputProperties const> = 0;
-		        auto InputPropertiesOf(size_t index) -> InputProperties const*;
+		        auto InputPropertiesOf(size_t index) const -> InputProperties const*;
 		virtual bool IsAnyInputActive() const = 0;
 		virtual double InputValue(size_t input) const = 0;
 		virtual double InputQuality(size_t input) const { return 1.0; } /// 0-1
@@ -216,17 +245,29 @@ namespace libgameinput
 			return this->InputValueFrom(std::forward<RANGE>(range), std::make_index_sequence<size>{});
 		}
 
-		virtual bool IsInputPressed(size_t input) const { return InputValue(input) >= ValidInputs()[input].PressedThreshold; }
+		virtual bool IsInputPressed(size_t input) const 
+		{ 
+			const auto props = InputPropertiesOf(input);
+			return props && InputValue(input) >= props->PressedThreshold;
+		}
 		virtual double InputValueLastFrame(size_t input) const = 0;
-		virtual bool WasInputPressedLastFrame(size_t input) const { return InputValueLastFrame(input) >= ValidInputs()[input].PressedThreshold; }
+		virtual bool WasInputPressedLastFrame(size_t input) const 
+		{ 
+			const auto props = InputPropertiesOf(input);
+			return props && InputValueLastFrame(input) >= props->PressedThreshold;
+		}
 		virtual bool SetInputUpdateFrequency(Seconds freq) { return false; }
 		virtual void ResetInput(size_t input) {} /// used, for example, to set a delta-based input to an origin value
 
 		/// TODO: Force feedback per input
 
-		virtual bool CanTriggerNavigation(UINavigationInput input) const = 0;
-		virtual bool IsNavigationPressed(UINavigationInput input) const = 0;
-		virtual bool WasNavigationPressedLastFrame(UINavigationInput input) const = 0;
+		/// The device's default navigation bindings. Like `ValidInputs`, this should be a table that is built once; the input 
+		/// system copies it into its navigation tables when the device connects, and evaluates all devices' tables together, 
+		/// with any remapping (see `IInputSystem::MapNavigation`). The default implementations of the queries below use it too.
+		virtual auto NavigationBindings() const -> std::span<NavigationBinding const> { return {}; }
+		virtual bool CanTriggerNavigation(UINavigationInput input) const;
+		virtual bool IsNavigationPressed(UINavigationInput input) const;
+		virtual bool WasNavigationPressedLastFrame(UINavigationInput input) const;
 
 		virtual size_t SubDeviceCount() const { return 0; }
 		virtual IInputDevice* SubDevice(size_t index) const { return nullptr; }
@@ -234,12 +275,16 @@ namespace libgameinput
 
 
 		virtual auto ValidOutputs() const->std::span<OutputProperties const> { return {}; }
-		        auto OutputPropertiesOf(size_t index) -> OutputProperties const*;
+		        auto OutputPropertiesOf(size_t index) const -> OutputProperties const*;
 		virtual bool SetOutput(size_t index, vec3 value) { return false; }
 		virtual bool ResetOutput(size_t index) { return false; }
 		virtual bool SendOutputData(size_t index, std::span<const uint8_t> data) { return false; }
 		virtual bool SetOutputCallback(size_t index, std::function<void(std::span<uint8_t>)> callback) { return false; }
 		virtual bool EnableOutput(size_t index, bool enable) { return false; }
+		/// `OutputScheduler` calls these around the writes of each flush, so backends can buffer the writes and send them as
+		/// one report
+		virtual void BeginOutputBatch() {}
+		virtual void EndOutputBatch() {}
 
 		/// TODO: Data
 		// virtual size_t DataCount() const = 0;
@@ -389,20 +434,29 @@ namespace libgameinput
 
 		/// TODO: Getting/setting layout or keycode mappings
 
-		virtual bool CanTriggerNavigation(UINavigationInput input) const override;
-		virtual bool IsNavigationPressed(UINavigationInput input) const override;
-		virtual bool WasNavigationPressedLastFrame(UINavigationInput input) const override;
+		/// Returns the shared ISO/US keyboard property table, indexed by scancode
+		virtual auto ValidInputs() const -> std::span<InputProperties const> override;
 
-	protected:
+		virtual auto NavigationBindings() const -> std::span<NavigationBinding const> override;
+
+		static constexpr size_t KeyboardButtonCount = size_t(KeyboardButton::RightGUI) + 1;
 
 		struct KeyboardButtonDescriptor
 		{
-			std::string Name{};
-			vec2 Position{};
-			std::string URI{};
+			std::string_view Name;
+			vec2 Position; /// In key units, on an ISO/US layout
+			std::string_view URI;
 		};
 
-		static std::map<size_t, KeyboardButtonDescriptor> mISOUSKeyboardButtons;
+		/// Returns nullptr for scancodes that do not represent a known key
+		static auto ButtonDescriptor(KeyboardButton button) -> KeyboardButtonDescriptor const*;
+		/// Constant-time; returns KeyboardButton::None if no key has the given name
+		static auto ButtonFromName(std::string_view name) -> KeyboardButton;
+
+	protected:
+
+		/// Indexed by scancode, generated at compile time
+		static std::span<KeyboardButtonDescriptor const> const mISOUSKeyboardButtons;
 	};
 
 	enum class MouseButton
@@ -442,6 +496,22 @@ namespace libgameinput
 		CannotDrop,
 	};
 
+	struct ISystemDevice;
+
+	struct MultiClickSettings
+	{
+		Seconds MaxInterval{ 0.5 }; /// between two presses of a multi-click
+		vec2 MaxDistance{ 4, 4 }; /// from the first press of a multi-click, in the units of the mouse position
+		int MaxCount = 0; /// the count starts over after this many clicks; 0 for no limit
+	};
+
+	struct MouseClickEvent
+	{
+		MouseButton Button = MouseButton::Left;
+		int Count = 1; /// 1 for a single click, 2 for a double click, etc.
+		vec2 Position{};
+		TimePoint Time{};
+	};
 	struct IMouseDevice : public virtual IInputDevice
 	{
 		using IInputDevice::IInputDevice;
@@ -456,6 +526,18 @@ namespace libgameinput
 		virtual vec2 Position() const { return { this->InputValue(XAxisInputID()), this->InputValue(YAxisInputID()) }; }
 		virtual double Wheel() const { return this->InputValue(VerticalWheelInputID()); }
 
+		/// Relative motion inputs, accumulated over the frame with sub-pixel precision; InvalidIndex if the device has none
+		virtual size_t XDeltaInputID() const { return InvalidIndex; }
+		virtual size_t YDeltaInputID() const { return InvalidIndex; }
+		virtual vec2 Delta() const
+		{
+			if (XDeltaInputID() == InvalidIndex || YDeltaInputID() == InvalidIndex)
+				return {};
+			return { this->InputValue(XDeltaInputID()), this->InputValue(YDeltaInputID()) };
+		}
+		/// This frame's relative motion as timestamped deltas, e.g. for aiming code that integrates motion over the frame
+		virtual auto MotionPath() const -> std::span<MouseMotionSample const> { return {}; }
+
 		virtual void ShowCursor(bool show) {}
 		virtual bool IsCursorVisible() const { return true; }
 		virtual bool IsCursorShapeAvailable(MouseCursorShape shape) const { return shape == MouseCursorShape::Default; }
@@ -472,15 +554,202 @@ namespace libgameinput
 		virtual void SetValidRegions(rec2 const& rec) { this->SetValidRegions(std::span{ &rec, 1 }); }
 		virtual void SetValidRegionsFromDisplays() = 0;
 
-		/// TODO: Double-click support
+		/// Multi-clicks are counted when buttons are pressed, from the timestamps backends report them with, so they are
+		/// accurate at any frame rate. Returns the click count of the button's latest press while it is held; otherwise the
+		/// highest count it was pressed with this frame, so that quick clicks are not missed; and 0 if neither.
+		int ClickCount(MouseButton button) const;
+		int ClickCountLastFrame(MouseButton button) const;
+		/// Backends may expose click counts as inputs, so that e.g. double clicks can be mapped with `MapAxisToButton`
+		virtual size_t ClickCountInputID(MouseButton button) const { return InvalidIndex; }
+		/// Multi-clicks that happened this frame, in order
+		auto ClickEvents() const -> std::span<MouseClickEvent const> { return std::span{ mClickEvents }.first(mClickEventCount); }
+
+		void SetMultiClickSettings(MultiClickSettings const& settings) { mMultiClickSettings = settings; }
+		auto GetMultiClickSettings() const -> MultiClickSettings const& { return mMultiClickSettings; }
+		/// Uses `SystemConfig::DoubleClickTime` and `DoubleClickDistance`, where the system device reports them
+		void UseSystemMultiClickSettings(ISystemDevice const& system);
+
+		/// Derived classes that override this must call it
+		virtual void NewFrame() override;
 
-		virtual bool CanTriggerNavigation(UINavigationInput input) const override;
-		virtual bool IsNavigationPressed(UINavigationInput input) const override;
-		virtual bool WasNavigationPressedLastFrame(UINavigationInput input) const override;
+		/// Built on first use, from the wheel inputs of the backend
+		virtual auto NavigationBindings() const -> std::span<NavigationBinding const> override;
 
 	protected:
 
 		std::vector<rec2> mValidRegions;
+
+		/// Backends should call these for every button event, with the event's timestamp
+		void RecordButtonPress(MouseButton button, vec2 position, TimePoint time);
+		void RecordButtonRelease(MouseButton button);
+
+	private:
+
+		static constexpr size_t ButtonSlots = size_t(MouseButton::Button5) + 1;
+		static constexpr size_t MaxClickEventsPerFrame = 16;
+
+		struct ClickState
+		{
+			int Count = 0; /// of the latest press
+			bool Held = false;
+			int PressedThisFrame = 0; /// the highest count pressed this frame
+			int LastFrame = 0;
+			TimePoint LastPressTime{};
+			vec2 FirstPressPosition{};
+		};
+
+		MultiClickSettings mMultiClickSettings;
+		std::array<ClickState, ButtonSlots> mClicks{};
+		std::array<MouseClickEvent, MaxClickEventsPerFrame> mClickEvents{};
+		size_t mClickEventCount = 0;
+
+		mutable std::array<NavigationBinding, 6> mNavigationBindings{};
+		mutable size_t mNavigationBindingCount = InvalidIndex;
+	};
+
+	struct GestureDevice;
+
+	struct TouchContact
+	{
+		size_t ID = InvalidIndex; /// unique for the session; a new touch gets a new ID even if the OS reuses its own
+		vec2 Position{};
+		vec2 StartPosition{};
+		vec2 LastFramePosition{};
+		double Pressure = 1.0; /// 0-1; 1 on devices that do not report pressure
+		vec2 Size{}; /// of the contact area; 0 if unknown
+		TimePoint StartTime{};
+		TimePoint LastChangeTime{};
+		size_t Control = InvalidIndex; /// the virtual control that captured this contact when it began
+	};
+
+	enum class TouchInput
+	{
+		AnyContact,
+		ContactCount,
+		PrimaryX, /// the primary contact is the oldest one still down
+		PrimaryY,
+		PrimaryPressure,
+		FirstVirtualControl,
+	};
+
+	/// Touchscreens and multitouch touchpads. Contacts are kept in a fixed pool, and the per-frame lists of contacts
+	/// that began, moved and ended are fixed-size too, so tracking contacts never allocates.
+	/// Screen buttons and sticks can be added as virtual controls; they become inputs of the device, so they can be mapped
+	/// like physical ones (`MapButton`, `MapAxis2D`). A contact is captured by the topmost control under the point where it
+	/// began, and stays with it until it ends.
+	struct ITouchDevice : public virtual IInputDevice
+	{
+		using IInputDevice::IInputDevice;
+
+		static constexpr size_t MaxContacts = 16;
+		static constexpr size_t MaxContactEventsPerFrame = 64;
+		static constexpr size_t MaxVirtualControls = 64;
+
+		/// Contacts down now, oldest first
+		auto Contacts() const -> std::span<TouchContact const> { return std::span{ mFrame.Contacts }.first(mFrame.ContactCount); }
+		auto Contact(size_t id) const -> TouchContact const*;
+		auto PrimaryContact() const -> TouchContact const* { return mFrame.ContactCount ? &mFrame.Contacts[0] : nullptr; }
+
+		auto BeganContacts() const -> std::span<TouchContact const> { return std::span{ mFrame.Began }.first(mFrame.BeganCount); }
+		/// One entry per contact that moved this frame, with its latest state
+		auto MovedContacts() const -> std::span<TouchContact const> { return std::span{ mFrame.Moved }.first(mFrame.MovedCount); }
+		/// Contacts that ended (or were cancelled) this frame, as they were when they ended
+		auto EndedContacts() const -> std::span<TouchContact const> { return std::span{ mFrame.Ended }.first(mFrame.EndedCount); }
+		/// Began/moved/ended entries that did not fit in this frame's lists
+		auto DroppedContactEvents() const -> size_t { return mFrame.DroppedEvents; }
+
+		/// Return the index of the control's first input. Controls should be added before the device's inputs are mapped.
+		auto AddVirtualButton(std::string name, rec2 area, std::string glyph_uri = {}) -> size_t;
+		/// Adds two inputs, X and Y, from -1 to 1 at `radius` from the center; up is negative Y, like on gamepad sticks.
+		/// A floating stick is centered where its contact began, rather than at the center of its area.
+		auto AddVirtualStick(std::string name, rec2 area, double radius, bool floating = false) -> size_t;
+		void ClearVirtualControls();
+		/// Returns the index (in the order of adding) of the topmost (last added) control at the point, or InvalidIndex
+		auto VirtualControlAt(vec2 point) const -> size_t;
+
+		/// Lets a gesture device recognize gestures from contacts not captured by virtual controls
+		void ForwardContactsTo(GestureDevice* gestures) { mGestures = gestures; }
+
+		virtual auto ValidInputs() const -> std::span<InputProperties const> override { return mInputProperties; }
+		virtual bool IsAnyInputActive() const override { return mFrame.ContactCount > 0; }
+		virtual double InputValue(size_t input) const override;
+		virtual double InputValueLastFrame(size_t input) const override { return input < mLastValues.size() ? mLastValues[input] : 0.0; }
+		virtual bool CanTriggerNavigation(UINavigationInput input) const override { return false; }
+		virtual bool IsNavigationPressed(UINavigationInput input) const override { return false; }
+		virtual bool WasNavigationPressedLastFrame(UINavigationInput input) const override { return false; }
+		/// Derived classes that override this must call it
+		virtual void NewFrame() override;
+
+	protected:
+
+		/// Backends call these with the OS's contact ids, as events arrive
+		void ContactBegan(size_t os_contact, vec2 position, TimePoint time, double pressure = 1.0, vec2 size = {});
+		void ContactMoved(size_t os_contact, vec2 position, TimePoint time, double pressure = 1.0, vec2 size = {});
+		void ContactEnded(size_t os_contact, vec2 position, TimePoint time);
+		void ContactCancelled(size_t os_contact, TimePoint time);
+		void CancelAllContacts(TimePoint time);
+
+	private:
+
+		struct ContactFrame
+		{
+			std::array<TouchContact, MaxContacts> Contacts{};
+			std::array<size_t, MaxContacts> OSContacts{};
+			std::array<size_t, MaxContacts> MovedEntries{}; /// index into `Moved` of each contact, or InvalidIndex
+			size_t ContactCount = 0;
+			std::array<TouchContact, MaxContactEventsPerFrame> Began{}, Moved{}, Ended{};
+			size_t BeganCount = 0, MovedCount = 0, EndedCount = 0, DroppedEvents = 0;
+		};
+
+		struct VirtualControl
+		{
+			rec2 Area{};
+			size_t FirstInput = 0;
+			double Radius = 0; /// 0 for buttons
+			bool Floating = false;
+		};
+
+		ContactFrame mFrame;
+		size_t mNextContactID = 0;
+		size_t mFirstContactOfFrame = 0;
+
+		auto FindContact(size_t os_contact) const -> size_t;
+		void RemoveContact(size_t index, TimePoint time, bool cancelled);
+		bool AddContactEvent(std::array<TouchContact, MaxContactEventsPerFrame>& list, size_t& count, TouchContact const& contact);
+
+		/// Virtual controls are hit-tested through a coarse grid over their bounds; each cell has a bit per control overlapping it
+		static constexpr size_t HitGridSize = 8;
+		std::vector<VirtualControl> mControls;
+		rec2 mHitGridBounds{};
+		std::array<uint64_t, HitGridSize * HitGridSize> mHitGrid{};
+		void RebuildHitGrid();
+
+		std::vector<InputProperties> mInputProperties = BaseInputProperties();
+		/// Input values are recomputed from the contacts on the first query after they change
+		mutable std::vector<double> mValues = std::vector<double>(mInputProperties.size());
+		mutable bool mValuesStale = false;
+		std::vector<double> mLastValues = std::vector<double>(mInputProperties.size());
+		static auto BaseInputProperties() -> std::vector<InputProperties>;
+		void RefreshValues() const;
+
+		GestureDevice* mGestures = nullptr;
+	};
+
+	/// A touch device driven by calls from the application, e.g. for tests, replays, or touch events forwarded from a UI framework
+	struct SyntheticTouchDevice : public ITouchDevice
+	{
+		SyntheticTouchDevice(IInputSystem& sys) : IInputDevice(sys), ITouchDevice(sys) {}
+
+		using ITouchDevice::ContactBegan;
+		using ITouchDevice::ContactMoved;
+		using ITouchDevice::ContactEnded;
+		using ITouchDevice::ContactCancelled;
+		using ITouchDevice::CancelAllContacts;
+
+		virtual enum_flags<InputDeviceFlags> Flags() const override { return {}; }
+		virtual bool IsStringPropertyValid(StringProperty property) const override { return property == StringProperty::Name; }
+		virtual std::string_view StringPropertyValue(StringProperty property, std::string_view lang = {}) const override { return property == StringProperty::Name ? "Synthetic Touch Device" : ""; }
+		virtual void ForceRefresh() override {}
 	};
 
 	struct IGamepadDevice : public virtual IInputDevice
@@ -511,8 +780,17 @@ namespace libgameinput
 		}
 		virtual float StickAxisValueLastFrame(uint8_t stick_num, uint8_t axis_num) const = 0;
 
+		/// The first two axes of the stick, after the stick deadzone is applied (see IInputSystem::SetStickDeadZone)
+		vec2 ProcessedStickValue(uint8_t stick_num) const;
+		vec2 ProcessedStickValueLastFrame(uint8_t stick_num) const;
+
 	protected:
 
+		friend struct IInputSystem;
+
+		/// Set by the input system; the slots for stick N are (mFirstStickSlot + N*2) for this frame, and the one after it for the last frame
+		size_t mFirstStickSlot = InvalidIndex;
+
 		virtual auto StickAxisInputs(uint8_t stick_num) -> std::array<size_t, 3> { return {InvalidIndex,InvalidIndex,InvalidIndex}; } 
 		virtual auto InputForButton(uint8_t button_num) -> size_t { return InvalidIndex; }
 	};
@@ -537,11 +815,14 @@ namespace libgameinput
 		virtual uint8_t StickAxisCount(uint8_t stick_num) const override;
 		virtual uint8_t ButtonCount() const override;
 
-		virtual bool CanTriggerNavigation(UINavigationInput input) const override;
-		virtual bool IsNavigationPressed(UINavigationInput input) const override;
-		virtual bool WasNavigationPressedLastFrame(UINavigationInput input) const override;
+		/// Returns the shared Xbox gamepad property table (buttons first, then `Axes`)
+		virtual auto ValidInputs() const -> std::span<InputProperties const> override;
+
+		/// The sticks page and scroll, in the stick's direction
+		virtual auto NavigationBindings() const -> std::span<NavigationBinding const> override;
 
 		static constexpr uint64_t DefaultButtonCount = 14;
+		static constexpr uint64_t DefaultAxisCount = 6;
 
 		enum class Axes
 		{
@@ -552,6 +833,10 @@ namespace libgameinput
 			LeftTrigger,
 			RightTrigger,
 		};
+
+	protected:
+
+		virtual auto StickAxisInputs(uint8_t stick_num) -> std::array<size_t, 3> override;
 	};
 
 	/// TODO: api for this
@@ -592,6 +877,18 @@ namespace libgameinput
 		virtual auto Transform() const -> glm::tmat4x4<double>;
 
 		virtual std::string PositionUnits() const = 0;
+
+		/// Trackers usually report much faster than frames are rendered; backends should record every sample they get 
+		/// (from a single thread), so that the pose can be queried for any time, like the predicted display time of a frame.
+		/// Queries are lock-free and allocation-free, and safe from any thread.
+		void RecordPose(Pose const& pose) { mPoseHistory.Record(pose); }
+		void RecordCurrentPose(TimePoint time) { RecordPose({ time, Position(), Rotation() }); }
+		auto PoseAt(TimePoint time) const -> std::optional<Pose> { return mPoseHistory.At(time); }
+		auto Poses() const -> PoseHistory const& { return mPoseHistory; }
+
+	protected:
+
+		PoseHistory mPoseHistory;
 	};
 
 	struct IEyeTrackingDevice : public virtual IInputDevice
@@ -602,7 +899,24 @@ namespace libgameinput
 		virtual auto LeftEye() const -> IVirtualSpaceDevice* { return dynamic_cast<IVirtualSpaceDevice*>(SubDevice(LeftEyeSubDeviceIndex())); }
 		virtual auto RightEye() const -> IVirtualSpaceDevice* { return dynamic_cast<IVirtualSpaceDevice*>(SubDevice(RightEyeSubDeviceIndex())); }
 
+		/// Returns the point the eyes converge on. Once a backend calls `UpdateEyeFocus`, this is the value computed for the
+		/// latest sample, rather than being recomputed from both eyes on every query.
 		virtual vec3 EyeFocusPosition() const;
+		/// The focus with jitter removed; NaN before the first sample
+		vec3 FilteredEyeFocusPosition() const { return mGazeFilter.HasValue() ? mGazeFilter.Value() : vec3{ NAN, NAN, NAN }; }
+
+		/// Backends should call this whenever new eye data arrives, to compute the focus once per sample and filter it
+		void UpdateEyeFocus(TimePoint sample_time);
+		void SetGazeFilterSettings(OneEuroFilterSettings const& settings) { mGazeFilter.Settings = settings; }
+		void ResetGazeFilter() { mGazeFilter.Reset(); mLastGazeSampleTime = {}; }
+
+	protected:
+
+		OneEuroFilter<vec3> mGazeFilter;
+		vec3 mEyeFocus{ NAN, NAN, NAN };
+		TimePoint mLastGazeSampleTime{};
+
+		vec3 ComputeEyeFocusPosition() const;
 	};
 
 	struct IHandTrackingDevice : public virtual IVirtualSpaceDevice
@@ -704,13 +1018,15 @@ namespace libgameinput
 			PreferredUIScale,
 			PrimaryAccentColor,
 			SecondaryAccentColor,
-			KeyRepeatFrequency,
-			KeyRepeatDelay,
+			KeyRepeatFrequency, /// in repeats per second
+			KeyRepeatDelay, /// in seconds
 			DPI,
 			PreferredTextSize,
 			LimitAnimations, /// 0 - no/minimal animations, 1 - full animations
 			AdminPrivileges,
 			ChassisFanCount,
+			DoubleClickTime, /// in seconds
+			DoubleClickDistance, /// X, Y = how far the pointer can move between the clicks of a double click, in pixels
 		};
 
 		enum class ColorblindnessType
@@ -732,6 +1048,9 @@ namespace libgameinput
 			HighContrast,
 		};
 
+		virtual bool IsSystemConfigValid(SystemConfig config) const { return false; }
+		virtual vec3 SystemConfigValue(SystemConfig config) const { return { NAN, NAN, NAN }; }
+
 		/// TODO: Listing connected devices, listing connection slots and their physical locations
 		/// Getting offset from machine to device if available
 	};
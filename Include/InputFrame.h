@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Common.h"
+
+#include <optional>
+
+namespace libgameinput
+{
+	/// How an axis is quantized; the neutral value is always exactly representable
+	struct AxisQuantization
+	{
+		double Min = -1;
+		double Neutral = 0;
+		double Max = 1;
+		uint8_t Bits = 8; /// 2-32
+	};
+
+	/// Describes the contents of a frame; the sender and receiver must use the same layout
+	struct InputFrameLayout
+	{
+		uint8_t PlayerCount = 1;
+		uint8_t ButtonCount = 0; /// per player, at most 64
+		std::vector<AxisQuantization> Axes; /// per player
+
+		/// The size of a full (non-delta) frame
+		auto MaxEncodedBits() const -> size_t;
+	};
+
+	/// The inputs of all players for a single tick
+	struct InputFrame
+	{
+		std::vector<uint64_t> Buttons; /// [player], one bit per button
+		std::vector<double> Axes; /// [player * axis count + axis]
+
+		static auto Empty(InputFrameLayout const& layout) -> InputFrame;
+
+		bool IsButtonPressed(size_t player, size_t button) const { return player < Buttons.size() && button < 64 && ((Buttons[player] >> button) & 1); }
+		void SetButton(size_t player, size_t button, bool pressed);
+	};
+
+	/// Bit-packs input frames. Frames can be encoded as deltas against a reference frame (e.g. the last acknowledged one),
+	/// in which case unchanged players cost 1 bit, and unchanged axes of changed players cost 1 bit each.
+	///
+	/// Encoding is lossy (axes are quantized), so both sides should keep the *decoded* frames as references,
+	/// which is what `Quantize` returns.
+	struct InputFrameEncoder
+	{
+		explicit InputFrameEncoder(InputFrameLayout layout);
+
+		auto Layout() const -> InputFrameLayout const& { return mLayout; }
+
+		/// Appends the encoded frame to `out`, so the same buffer can be reused every tick
+		void Encode(InputFrame const& frame, InputFrame const* reference, std::vector<uint8_t>& out) const;
+		auto Encode(InputFrame const& frame, InputFrame const* reference = nullptr) const -> std::vector<uint8_t>;
+
+		/// Returns nullopt if the data is malformed, or is a delta frame and no reference is given
+		auto Decode(std::span<uint8_t const> data, InputFrame const* reference = nullptr) const -> std::optional<InputFrame>;
+
+		/// Returns the frame as the receiver will see it
+		auto Quantize(InputFrame const& frame) const -> InputFrame;
+
+		auto QuantizeAxis(size_t axis, double value) const -> uint32_t;
+		auto DequantizeAxis(size_t axis, uint32_t code) const -> double;
+
+	private:
+
+		struct AxisCodec
+		{
+			double Neutral = 0;
+			double Scale = 0; /// units per step
+			int64_t MinCode = 0;
+			int64_t MaxCode = 0;
+			uint8_t Bits = 8;
+		};
+
+		InputFrameLayout mLayout;
+		std::vector<AxisCodec> mAxisCodecs;
+		uint64_t mButtonMask = 0;
+	};
+}
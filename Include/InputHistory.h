@@ -0,0 +1,57 @@
+#pragma once
+
+#include "InputFrame.h"
+
+namespace libgameinput
+{
+	/// A ring of per-tick input frames for rollback netcode.
+	/// Inputs of local players are set every tick; inputs of remote players are set when they arrive, possibly many ticks late.
+	/// Until then, remote players are predicted to repeat their last confirmed input. When a late input differs from what was
+	/// predicted, the earliest such tick is remembered, so the simulation can roll back to it.
+	struct InputHistory
+	{
+		InputHistory(InputFrameLayout const& layout, size_t capacity = 128);
+
+		auto Capacity() const -> size_t { return mSlots.size(); }
+		auto Layout() const -> InputFrameLayout const& { return mLayout; }
+
+		/// Sets the confirmed input of a player for a tick. Ticks that have fallen out of the ring are ignored.
+		/// Returns true if the input differs from what was predicted for that tick.
+		bool SetInput(uint64_t tick, size_t player, uint64_t buttons, std::span<double const> axes);
+		bool SetInput(uint64_t tick, size_t player, InputFrame const& from_frame);
+
+		/// Returns the frame for the tick, with unconfirmed players predicted; nullptr if the tick is not in the ring
+		/// (i.e. older than `Capacity()` ticks before the newest tick).
+		auto Frame(uint64_t tick) -> InputFrame const*;
+
+		bool IsConfirmed(uint64_t tick, size_t player) const;
+		/// Returns true if all players are confirmed for the tick
+		bool IsComplete(uint64_t tick) const;
+
+		/// Returns the earliest tick whose prediction turned out to be wrong since the last call, and forgets it
+		auto TakeRollbackTick() -> std::optional<uint64_t>;
+
+		auto NewestTick() const -> uint64_t { return mNewestTick; }
+
+	private:
+
+		struct Slot
+		{
+			uint64_t Tick = ~uint64_t{};
+			uint64_t ConfirmedPlayers = 0; /// bitmask
+			uint64_t PredictedPlayers = 0; /// bitmask of players whose predictions have been handed out in `Frame()`
+			InputFrame Frame;
+		};
+
+		InputFrameLayout mLayout;
+		std::vector<Slot> mSlots;
+		uint64_t mNewestTick = 0;
+		std::optional<uint64_t> mRollbackTick;
+
+		auto SlotFor(uint64_t tick) -> Slot&;
+		auto FindSlot(uint64_t tick) const -> Slot const*;
+		void Predict(Slot& slot, size_t player);
+		void CopyPlayer(InputFrame& to, InputFrame const& from, size_t player) const;
+		bool PlayerEquals(InputFrame const& a, InputFrame const& b, size_t player) const;
+	};
+}
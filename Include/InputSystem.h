@@ -4,15 +4,26 @@
 
 #include "InputDevice.h"
 #include "ErrorReporter.h"
+#include "GlyphAtlas.h"
+#include "AnalogProcessing.h"
+#include "KeyRepeat.h"
+#include "OutputScheduler.h"
+
+#include <atomic>
+#include <bitset>
+#include <set>
 
 namespace libgameinput
 {
+	struct InputSnapshot;
+	struct InputSnapshotRef;
+
 	struct IInputSystem
 	{
 		std::shared_ptr<IErrorReporter> ErrorReporter;
 		
 		IInputSystem(std::shared_ptr<IErrorReporter> error_reporter) noexcept;
-		virtual ~IInputSystem() = default;
+		virtual ~IInputSystem();
 
 		/// TODO: Loading of controller databases (SDL/Steam, etc.) - look how Godot does it
 
@@ -37,7 +48,6 @@ namespace libgameinput
 		/// - Environment
 		///		- Temperature, Light, Magnetic field, Pressure, Humidity
 		/// - Proximity
-		/// - Touchpad
 		/// - GPS
 		/// - Step tracker
 		/// - Altitude
@@ -87,7 +97,13 @@ namespace libgameinput
 		void MapKey(KeyboardButton key, Input to_input) { MapButton((size_t)key, KeyboardDeviceID, to_input); }
 		void MapMouse(MouseButton mouse_button, Input to_input) { MapButton((size_t)mouse_button, MouseDeviceID, to_input); }
 		void MapGamepad(XboxGamepadButton pad_button, Input to_input) { MapButton((size_t)pad_button, FirstGamepadDeviceID, to_input); }
+		/// The input is pressed while the navigation input is, on any device
 		void MapNavigation(UINavigationInput ui_input, Input to_input);
+		/// Binds a device input to a navigation input; the first binding of a navigation input on a device replaces the device's
+		/// defaults (see `IInputDevice::NavigationBindings`) for it, and `InvalidIndex` just removes them. Bindings are kept when 
+		/// the device reconnects. A negative threshold responds to the negative direction of an axis, like in `MapAxisToButton`.
+		void MapNavigation(size_t physical_input, InputDeviceIndex of_device, UINavigationInput to_ui_input, double press_threshold = std::numeric_limits<double>::quiet_NaN());
+		void ResetNavigationMappings(InputDeviceIndex of_device);
 		
 		/// TODO: void BindButtonPressed(Input button, func callback); /// maybe Bind* functions should return RegisteredCallbackID ?
 		/// TODO: void BindButtonReleased(Input button, func callback);
@@ -106,7 +122,7 @@ namespace libgameinput
 
 		/// TODO: Unmap(???) /// Maybe Map* functions should return a MappingID ?
 		
-		/// TODO: Screen buttons/joysticks
+		/// Screen buttons/joysticks are virtual controls of an `ITouchDevice`, mapped with `MapButton` and `MapAxis2D`
 		
 		void MapKeyAndButton(Input to_input, KeyboardButton key, XboxGamepadButton pad_button)
 		{
@@ -116,7 +132,11 @@ namespace libgameinput
 
 		void MapButton(size_t physical_button, InputDeviceIndex of_device, Input to_input);
 		void MapAxis1D(size_t physical_axis, InputDeviceIndex of_device, Input to_input);
+		/// If the axes are the two axes of a gamepad stick, the stick deadzone is used instead of per-axis processing
 		void MapAxis2D(size_t physical_axis1, size_t physical_axis2, InputDeviceIndex of_device, Input to_input);
+		/// The button is considered pressed when the axis reaches `press_threshold`, and released when it falls to `release_threshold` or below.
+		/// Negative thresholds make the button respond to the negative direction of the axis.
+		void MapAxisToButton(size_t physical_axis, InputDeviceIndex of_device, double press_threshold, double release_threshold, Input to_input);
 
 		/// TODO: Named mappings and layers, like in steam controller API
 		void ClearAllMappings();
@@ -129,6 +149,20 @@ namespace libgameinput
 		void MapButtonToAxis(size_t physical_button, InputDeviceIndex of_device, double to_pressed_value, double and_released_value, Input of_input);
 		/// mapPhysicalButton:ofDevice:toPressedValue:andReleasedValue:ofAxisInput:
 
+		/// Contributions of all buttons mapped to the same 2D axis are summed, and the result is normalized, so that diagonals are not faster
+		void MapButtonToAxis2D(size_t physical_button, InputDeviceIndex of_device, vec2 to_pressed_value, Input of_input);
+		/// Up is negative Y, like on gamepad sticks, so keys and sticks can be mapped to the same input
+		void MapKeysToAxis2D(KeyboardButton up, KeyboardButton down, KeyboardButton left, KeyboardButton right, Input of_input)
+		{
+			MapButtonToAxis2D((size_t)up, KeyboardDeviceID, { 0, -1 }, of_input);
+			MapButtonToAxis2D((size_t)down, KeyboardDeviceID, { 0, 1 }, of_input);
+			MapButtonToAxis2D((size_t)left, KeyboardDeviceID, { -1, 0 }, of_input);
+			MapButtonToAxis2D((size_t)right, KeyboardDeviceID, { 1, 0 }, of_input);
+		}
+
+		/// Exponentially smooths the value of the axis input, approaching the target by ~63% every `time_constant`; 0 disables smoothing
+		void SetAxisSmoothing(Input of_input, Seconds time_constant);
+
 		bool IsButtonPressed(Input input_id);
 		bool IsButtonPressed(MouseButton but);
 		bool IsKeyPressed(KeyboardButton key);
@@ -141,19 +175,96 @@ namespace libgameinput
 		bool WasButtonReleased(MouseButton but);
 		bool WasKeyReleased(KeyboardButton key);
 
+		/// Repeats are generated by the library, not taken from the OS, so held keys, gamepad buttons and navigation inputs 
+		/// all repeat the same way (see `SetKeyRepeatSettings`). The count is of the repeats since the press, 0 while not held.
 		int  ButtonRepeatCount(Input input_id);
+		/// Whether the button repeated this frame; with `WasButtonPressed`, this is what menus usually want
+		bool WasButtonRepeated(Input input_id);
 
+		/// Navigation inputs of all devices are resolved together with the mappings, into one bit per `UINavigationInput`,
+		/// so menus can test any number of them without querying the devices
+		auto NavigationPressedMask() -> uint32_t;
+		auto NavigationPressedLastFrameMask() -> uint32_t;
 		bool IsNavigationPressed(UINavigationInput input_id);
 		bool WasNavigationPressed(UINavigationInput input_id);
 		bool WasNavigationReleased(UINavigationInput input_id);
 		int  NavigationRepeatCount(UINavigationInput input_id);
+		bool WasNavigationRepeated(UINavigationInput input_id);
+
+		/// Held inputs are kept in a timer wheel, so the cost per frame depends on the inputs held, not on the actions mapped.
+		/// Repeat state does not survive remapping: inputs held across it start their delay over.
+		void SetKeyRepeatSettings(KeyRepeatSettings const& settings) { mRepeats.Settings = settings; }
+		auto GetKeyRepeatSettings() const -> KeyRepeatSettings const& { return mRepeats.Settings; }
+		/// Takes the delay and rate from the `KeyRepeatDelay` and `KeyRepeatFrequency` system configs, if the system provides them
+		void UseSystemKeyRepeatSettings(ISystemDevice const& system);
 
 		float AxisValue(Input of_input);
 		vec2 Axis2DValue(Input of_input);
 
+		/// Returns the value of a device input after deadzone, normalization, response curve and sensitivity are applied.
+		/// All analog inputs of all devices are processed together, at most once per frame, the first time any of them is queried.
+		/// Digital inputs, stepped inputs (with a `StepSize`) and inputs that do not return to neutral (like the mouse position) 
+		/// are returned unprocessed.
+		double ProcessedInputValue(InputDeviceIndex of_device, size_t input, bool last_frame = false);
+		/// Overrides the settings taken from the input's properties; they are kept when devices are reconnected
+		void SetAnalogSettings(InputDeviceIndex of_device, size_t input, AnalogChannelSettings const& settings);
+		/// Forces the analog inputs to be processed now, e.g. right after `Update()`, to keep the cost out of gameplay code
+		void ProcessAnalogInputs();
+		/// Evaluates all mappings; like `ProcessAnalogInputs()`, this happens automatically at most once per frame, on the first query
+		void ResolveMappings();
+
+		/// Rollback support: the complete resolved state of all actions of all players (pressed, edges, axis values, smoothing and 
+		/// hysteresis state) is kept in flat, trivially copyable arrays, and can be saved to and restored from a caller-provided buffer
+		/// with a few memcpys. A restored state is returned by all queries until the next `Update()`. During a tick (see `BeginTick`), the tick state is saved and restored instead.
+		/// Snapshots are only valid while the mappings stay the same; `RestoreActionState` returns false for stale or malformed snapshots.
+		auto ActionStateSize() -> size_t;
+		void SnapshotActionState(std::span<std::byte> into);
+		void SnapshotActionState(std::vector<std::byte>& into) { into.resize(ActionStateSize()); SnapshotActionState(std::span{ into }); }
+		bool RestoreActionState(std::span<std::byte const> from);
+
+		/// Fixed timestep sampling, for simulations that tick at a different rate than frames are rendered.
+		/// Between `BeginTick` and `EndTick`, button and axis queries return the state of the tick that ends at `tick_end`, built
+		/// from the changes that happened since the previous tick: every press and release of an action lands in exactly one 
+		/// tick (so a release and press within a tick is reported by both `WasButtonReleased` and `WasButtonPressed`), a press 
+		/// and release within one tick still reads as pressed for that tick, and analog values are averaged over the tick.
+		/// Changes are sampled every `Update()` and stamped with the time of the previous one; backends that get timestamped events 
+		/// can report digital changes precisely with `ReportInputChange`. `tick_end` must use the same clock as `TimePoint`, and increase.
+		void BeginTick(TimePoint tick_end);
+		void EndTick();
+		bool InTick() const { return mTickActive; }
+
+		/// Thread-safe access to the input state: `Update()` publishes an immutable snapshot of the frame that just ended
+		/// (resolved actions, keys, mouse buttons and position), which any thread can read while the main thread keeps 
+		/// processing events. `PublishSnapshot()` publishes the current state right away, e.g. right after the events of the 
+		/// frame are pumped. Snapshots are filled into a small pool of buffers that are reused once no reader holds them,
+		/// so publishing does not allocate in steady state, and acquiring a snapshot is lock-free.
+		void PublishSnapshot();
+		/// Returns an empty reference if nothing was published yet. Readers should not hold on to snapshots for 
+		/// longer than a frame or two, or the pool will have to grow.
+		auto AcquireSnapshot() const -> InputSnapshotRef;
+
+		/// Late latching: re-reads only the devices feeding the late-latched actions, reprocesses only the analog channels and 
+		/// sticks behind them, and re-evaluates only those actions, without touching the rest of the frame state. Meant to be called right before 
+		/// submitting a frame for rendering, so that camera look or cursor position use input that is a simulation step newer.
+		/// Other threads see the latched values once `PublishSnapshot()` is called.
+		void LateLatch();
+		void SetLateLatched(Input action, bool late_latched = true);
+
+		/// Returns the first two axes of a gamepad stick after its deadzone is applied; like the other analog inputs, 
+		/// the sticks of all gamepads are processed together, at most once per frame
+		vec2 ProcessedStickValue(IGamepadDevice const& gamepad, uint8_t stick_num, bool last_frame = false);
+		void SetStickDeadZone(InputDeviceIndex of_gamepad, uint8_t stick_num, StickDeadZoneSettings const& settings);
+		/// Used for sticks that do not have their own settings
+		void SetDefaultStickDeadZone(StickDeadZoneSettings const& settings);
+
 		void ResetInput(Input input);
 		TimePoint InputPressedTime(Input input);
 
+		/// Rumble, LEDs and other outputs should be set through here rather than on the devices, from anywhere and as often as 
+		/// needed: intents are merged and written once per `Update()`, and only when they change the output
+		void PostOutput(InputDeviceIndex of_device, size_t output, OutputIntent const& intent);
+		auto Outputs() -> OutputScheduler& { return mOutputs; }
+
 		/// TODO: Some sort of input buffering?
 
 		virtual vec2 MousePosition() const;
@@ -161,6 +272,7 @@ namespace libgameinput
 		/// TODO: Input Command callbacks (Down, Up, Press, Hold, etc)
 
 		void InjectInputChange(Input input, vec3 value, bool include_in_recording = true);
+		/// The navigation input stays pressed until it is injected released
 		void InjectInputChange(UINavigationInput input, bool value, bool include_in_recording = true);
 
 		IInputDevice* LastDeviceActive() const { return mLastActiveDevice; }
@@ -169,6 +281,15 @@ namespace libgameinput
 		std::string ButtonNameForInput(Input input, std::string_view button_format);
 
 		std::string CurrentGlyphForInput(Input input) const;
+		/// Returns nullptr if the input is not mapped, or its glyph is not in the atlas
+		auto CurrentGlyphRectForInput(Input input, GlyphAtlas const& atlas) const -> GlyphAtlasRect const*;
+		/// Uses the atlas set with `SetGlyphAtlas`
+		auto CurrentGlyphRectForInput(Input input) const -> GlyphAtlasRect const*;
+
+		/// The atlas gets the property tables of the connected devices bound, and rebound whenever devices change,
+		/// so that glyph rect lookups for prompts are indexed loads. The atlas must outlive the system, or be unset.
+		void SetGlyphAtlas(GlyphAtlas* atlas);
+		auto GlyphAtlasInUse() const -> GlyphAtlas const* { return mGlyphAtlas; }
 
 		std::string ButtonNamesForInput(Input input)
 		{
@@ -180,6 +301,13 @@ namespace libgameinput
 			return ButtonNameForInput(input, "{}");
 		}
 
+		/// Cached versions of the above, for prompts that are displayed every frame. 
+		/// The returned views stay valid until the mappings change, a device is connected or disconnected, 
+		/// or (for `CachedButtonNameForInput`) the last active device changes.
+		std::string_view CachedButtonNamesForInput(Input const& input, std::string_view button_format = "{}");
+		std::string_view CachedButtonNameForInput(Input const& input, std::string_view button_format = "{}");
+		void InvalidatePromptCache();
+
 		/// TODO: Input recording
 		void StartRecordingDeviceInput(int dev, size_t);
 		void StartRecordingDevice(int dev);
@@ -193,33 +321,260 @@ namespace libgameinput
 
 	protected:
 
+		enum class MappingType
+		{
+			Button,
+			Axis1D,
+			Axis2D,
+			ButtonToAxis,
+			ButtonToAxis2D,
+			AxisToButton,
+			Navigation, /// Inputs[0] is the UINavigationInput; compiled into a record per navigation binding
+		};
+
 		struct Mapping
 		{
 			InputDeviceIndex DeviceID = 0;
 			size_t Inputs[2] = { 0, InvalidIndex };
+			MappingType Type = MappingType::Button;
+			vec2 PressedValue{ 1, 0 }; /// for ButtonTo* mappings
+			vec2 ReleasedValue{ 0, 0 };
+			double PressThreshold = std::numeric_limits<double>::quiet_NaN(); /// NaN means "use the input's PressedThreshold"
+			double ReleaseThreshold = std::numeric_limits<double>::quiet_NaN();
 		};
 
 		IInputDevice* mLastActiveDevice = nullptr;
 		void SetLastActiveDevice(IInputDevice* device, TimePoint current_time);
 
+		/// Backends should call this whenever they add or remove entries in `mInputDevices`
+		void InputDevicesChanged();
+
+		/// Backends that receive timestamped events can call this for digital inputs, to make tick sampling exact
+		void ReportInputChange(InputDeviceIndex device, size_t input, double value, TimePoint timestamp);
+
 		std::vector<std::unique_ptr<IInputDevice>> mInputDevices;
 		std::map<void*, IGamepadDevice*> mJoystickMap;
 
-		IInputDevice* InputDevice(InputDeviceIndex id);
+		IInputDevice* InputDevice(InputDeviceIndex id) const;
 		std::string InputDeviceName(InputDeviceIndex id);
 
 		struct PlayerInformation
 		{
 			std::map<InputID, std::vector<Mapping>> Mappings;
 			std::vector<InputDeviceIndex> BoundDeviceIDs;
+			std::map<InputID, Seconds> AxisSmoothing;
+			std::map<InputID, size_t> ResolvedActionIndices; /// into mResolvedActions; rebuilt with the mapping records
+			std::set<InputID, std::less<>> LateLatchedActions;
 		};
 
 		PlayerInformation* GetPlayer(PlayerID id);
+		PlayerInformation const* GetPlayer(PlayerID id) const;
+
+		/// Finds the mapping of the input on the device that was most recently active
+		auto LastActiveMapping(Input input) const -> std::pair<IInputDevice*, Mapping const*>;
 
 		std::map<PlayerID, PlayerInformation> mPlayers;
 
 		void DebugInput();
 
+		struct AnalogChannelSource
+		{
+			InputDeviceIndex Device = 0;
+			size_t Input = 0;
+			bool LastFrame = false;
+		};
+
+		AnalogProcessor mAnalogProcessor;
+		std::vector<AnalogChannelSource> mAnalogChannelSources;
+		std::vector<std::vector<size_t>> mAnalogChannelsOfDevice; /// [device][input] -> channel, or InvalidIndex; the channel after it holds the last frame value
+		std::map<std::pair<InputDeviceIndex, size_t>, AnalogChannelSettings> mAnalogSettings;
+		bool mAnalogInputsStale = true;
+
+		struct StickSource
+		{
+			IGamepadDevice* Gamepad = nullptr;
+			InputDeviceIndex Device = 0;
+			uint8_t Stick = 0;
+			bool LastFrame = false;
+		};
+
+		StickProcessor mStickProcessor;
+		std::vector<StickSource> mStickSources;
+		std::map<std::pair<InputDeviceIndex, uint8_t>, StickDeadZoneSettings> mStickDeadZones;
+		StickDeadZoneSettings mDefaultStickDeadZone;
+
+		auto StickDeadZoneOf(InputDeviceIndex device, uint8_t stick) const -> StickDeadZoneSettings const&;
+
+		/// Mappings are compiled into flat evaluation records. Every record is evaluated the same way, regardless of its type:
+		///		value += Offset + Matrix * (source 0, source 1)
+		///		pressed = Direction * source 0 crosses the press/release thresholds (with hysteresis)
+		/// so digital and analog, keyboard and gamepad mappings all go through one branchless loop.
+		struct MappingSource
+		{
+			InputDeviceIndex Device = 0;
+			size_t Input = InvalidIndex;
+			IGamepadDevice const* Gamepad = nullptr; /// if set, the value comes from the processed stick instead of the input
+			uint8_t Stick = 0;
+			uint8_t Axis = 0;
+		};
+
+		struct MappingRecord
+		{
+			MappingType Type{}; /// not used during evaluation
+			uint32_t Action = 0;
+			uint32_t Sources[2] = { 0, 0 }; /// source 0 is always zero
+			float Offset[2] = { 0, 0 };
+			float Matrix[4] = { 0, 0, 0, 0 }; /// row-major 2x2
+			float Direction = 1;
+			float PressThreshold = 0.5f;
+			float ReleaseThreshold = 0.5f;
+			bool Pressed = false;
+			bool Latched = false;
+		};
+
+		struct ResolvedAction
+		{
+			vec2 Value{};
+			vec2 SmoothedValue{};
+			bool Pressed = false;
+			bool PressedLastFrame = false;
+			uint8_t TickEdges = 0; /// `TickRecordPressEdge`/`TickRecordReleaseEdge` of the action, during a tick
+			bool Normalize = false;
+			double SmoothingTime = 0;
+		};
+
+		struct ActionStateHeader
+		{
+			uint64_t MappingGeneration = 0;
+			uint64_t ActionCount = 0;
+			uint64_t RecordCount = 0;
+		};
+		static_assert(std::is_trivially_copyable_v<ResolvedAction> && std::is_trivially_copyable_v<ActionStateHeader>);
+
+		std::vector<MappingSource> mMappingSources;
+		std::vector<float> mMappingSourceValues; /// current frame values, then last frame values
+		std::vector<MappingRecord> mMappingRecords;
+		std::vector<ResolvedAction> mResolvedActions;
+		bool mMappingsChanged = true;
+		bool mMappingsStale = true;
+		TimePoint mLastResolveTime{};
+		double mLastResolveDeltaTime = 0; /// so late latching can redo the smoothing step of the frame
+		uint64_t mFrameNumber = 0;
+		uint64_t mResolvedFrameNumber = ~uint64_t{};
+		uint64_t mMappingGeneration = 0;
+
+		std::vector<uint32_t> mLateLatchRecords; /// records of late-latched actions
+		std::vector<uint32_t> mLateLatchActions;
+		std::vector<uint32_t> mLateLatchSources;
+		std::vector<InputDeviceIndex> mLateLatchDevices;
+		std::vector<uint32_t> mLateLatchChannels; /// sorted; analog channels and stick slots of the current frame values of the late-latched sources
+		std::vector<uint32_t> mLateLatchStickSlots;
+
+		void CompileMappings();
+		void MappingsChanged();
+		void GatherMappingSources();
+		auto MappingSourceValue(MappingSource const& source, bool last_frame) -> float;
+		static void EvaluateMappingRecord(MappingRecord& record, ResolvedAction& action, float const* current, float const* last);
+		/// If `repeats` is given, actions that were pressed or released since it last saw them are pressed or released in it
+		static void FinishActions(std::span<ResolvedAction> actions, double dt, KeyRepeatScheduler* repeats = nullptr, TimePoint now = {});
+
+		struct TickChange
+		{
+			TimePoint Time{};
+			uint32_t Source = 0;
+			float Value = 0;
+		};
+
+		static constexpr uint8_t TickRecordPressed = 1;
+		static constexpr uint8_t TickRecordPressEdge = 2;
+		static constexpr uint8_t TickRecordReleaseEdge = 4;
+
+		std::map<std::pair<InputDeviceIndex, size_t>, uint32_t> mMappingSourceOfInput;
+		std::vector<uint32_t> mRecordsOfSourceOffsets; /// records whose first source is S are mRecordsOfSource[offsets[S] .. offsets[S+1]]
+		std::vector<uint32_t> mRecordsOfSource;
+		std::vector<TickChange> mTickChanges;
+		std::vector<float> mTickReportedValues;
+		std::vector<float> mTickSourceValues;
+		std::vector<float> mTickSourceAverages;
+		std::vector<uint8_t> mTickRecordStates;
+		std::vector<ResolvedAction> mTickActions;
+		std::vector<uint32_t> mTickPressedRecords; /// [action] records pressed during the replay of a tick's changes
+		TimePoint mTickStart{};
+		TimePoint mLastUpdateTime{};
+		bool mTickSampling = false;
+		bool mTickActive = false;
+
+		void SampleTickChanges(TimePoint timestamp);
+		auto ResolvedActionIndexOf(Input const& input) -> size_t;
+		auto ResolvedActionOf(Input const& input) -> ResolvedAction const*;
+
+		/// Repeat keys are the resolved action indices, followed by the navigation inputs
+		KeyRepeatScheduler mRepeats;
+		OutputScheduler mOutputs;
+		GlyphAtlas* mGlyphAtlas = nullptr;
+
+		void UpdateNavigationRepeats(TimePoint now);
+
+		/// Navigation tables are built from the devices' default bindings and the remapped ones when devices connect,
+		/// and compiled with the mappings into `mNavigationRecords`, whose `Action` is the `UINavigationInput`
+		std::vector<std::vector<NavigationBinding>> mNavigationTables; /// [device]
+		std::map<std::pair<InputDeviceIndex, UINavigationInput>, std::vector<NavigationBinding>> mNavigationMappings;
+		std::vector<MappingRecord> mNavigationRecords;
+		uint32_t mNavigationPressed = 0; /// bit per `UINavigationInput`, as of the last resolve
+		uint32_t mNavigationPressedLastFrame = 0;
+		uint32_t mInjectedNavigation = 0;
+		uint32_t mInjectedNavigationLastFrame = 0;
+
+		void RebuildNavigationTables();
+		auto NavigationRepeatKey(UINavigationInput input) const -> uint32_t { return uint32_t(mResolvedActions.size() + size_t(input)); }
+
+		friend struct InputSnapshot;
+
+		struct SnapshotActionKey
+		{
+			PlayerID Player{};
+			InputID ActionID{};
+		};
+
+		std::shared_ptr<std::vector<SnapshotActionKey> const> mSnapshotActionKeys; /// [action index], sorted by player and action id; shared by all snapshots of a mapping generation
+		static constexpr size_t InitialSnapshotPoolSize = 3; /// one published, one being read, one being filled
+		std::vector<std::unique_ptr<InputSnapshot>> mSnapshotPool;
+		std::atomic<InputSnapshot*> mPublishedSnapshot = nullptr;
+
+		void RebuildAnalogChannels();
+		auto AnalogChannelOf(InputDeviceIndex device, size_t input) const -> size_t;
+		/// Like `ProcessAnalogInputs()`, but only for the current frame values behind the late-latched sources
+		void ProcessLateLatchedAnalogInputs();
+
+		struct PromptCacheKey
+		{
+			PlayerID Player{};
+			InputID ActionID{};
+			std::string Format{};
+		};
+
+		struct PromptCacheKeyView
+		{
+			PlayerID Player{};
+			std::string_view ActionID{};
+			std::string_view Format{};
+		};
+
+		struct PromptCacheKeyLess
+		{
+			using is_transparent = void;
+
+			template <typename A, typename B>
+			bool operator()(A const& a, B const& b) const
+			{
+				return std::forward_as_tuple(a.Player, std::string_view{ a.ActionID }, std::string_view{ a.Format }) 
+					< std::forward_as_tuple(b.Player, std::string_view{ b.ActionID }, std::string_view{ b.Format });
+			}
+		};
+
+		std::map<PromptCacheKey, std::string, PromptCacheKeyLess> mButtonNamesCache;
+		std::map<PromptCacheKey, std::string, PromptCacheKeyLess> mButtonNameCache; /// depends on the last active device
+
 		enum class InputChangeFlags
 		{
 			Injected,
@@ -241,6 +596,72 @@ namespace libgameinput
 		};
 	};
 
+	/// An immutable view of one frame of input, published by `IInputSystem::PublishSnapshot()`.
+	/// Queries behave like their `IInputSystem` counterparts at the time the snapshot was published.
+	struct InputSnapshot
+	{
+		using Input = IInputSystem::Input;
+
+		auto FrameNumber() const -> uint64_t { return mFrameNumber; }
+
+		bool IsButtonPressed(Input const& input_id) const;
+		bool IsButtonPressed(MouseButton but) const { return mMouseButtons.test((size_t)but); }
+		bool IsKeyPressed(KeyboardButton key) const { return mKeys.test((size_t)key); }
+
+		bool WasButtonPressed(Input const& input_id) const;
+		bool WasButtonPressed(MouseButton but) const { return mMouseButtons.test((size_t)but) && !mMouseButtonsLastFrame.test((size_t)but); }
+		bool WasKeyPressed(KeyboardButton key) const { return mKeys.test((size_t)key) && !mKeysLastFrame.test((size_t)key); }
+
+		bool WasButtonReleased(Input const& input_id) const;
+		bool WasButtonReleased(MouseButton but) const { return !mMouseButtons.test((size_t)but) && mMouseButtonsLastFrame.test((size_t)but); }
+		bool WasKeyReleased(KeyboardButton key) const { return !mKeys.test((size_t)key) && mKeysLastFrame.test((size_t)key); }
+
+		float AxisValue(Input const& of_input) const;
+		vec2 Axis2DValue(Input const& of_input) const;
+
+		vec2 MousePosition() const { return mMousePosition; }
+
+	private:
+
+		friend struct IInputSystem;
+		friend struct InputSnapshotRef;
+
+		auto ActionOf(Input const& input) const -> IInputSystem::ResolvedAction const*;
+
+		uint64_t mFrameNumber = 0;
+		std::shared_ptr<std::vector<IInputSystem::SnapshotActionKey> const> mActionKeys;
+		std::vector<IInputSystem::ResolvedAction> mActions;
+		std::bitset<IKeyboardDevice::KeyboardButtonCount> mKeys;
+		std::bitset<IKeyboardDevice::KeyboardButtonCount> mKeysLastFrame;
+		std::bitset<8> mMouseButtons;
+		std::bitset<8> mMouseButtonsLastFrame;
+		vec2 mMousePosition{};
+		mutable std::atomic<uint32_t> mReaders = 0;
+	};
+
+	/// Keeps a published snapshot from being reused while it is read
+	struct InputSnapshotRef
+	{
+		InputSnapshotRef() noexcept = default;
+		InputSnapshotRef(InputSnapshotRef&& other) noexcept : mSnapshot(std::exchange(other.mSnapshot, nullptr)) {}
+		InputSnapshotRef& operator=(InputSnapshotRef&& other) noexcept { if (this != &other) { Release(); mSnapshot = std::exchange(other.mSnapshot, nullptr); } return *this; }
+		~InputSnapshotRef() { Release(); }
+
+		explicit operator bool() const noexcept { return mSnapshot != nullptr; }
+		auto operator->() const noexcept -> InputSnapshot const* { return mSnapshot; }
+		auto operator*() const noexcept -> InputSnapshot const& { return *mSnapshot; }
+		auto Get() const noexcept -> InputSnapshot const* { return mSnapshot; }
+
+	private:
+
+		friend struct IInputSystem;
+
+		explicit InputSnapshotRef(InputSnapshot const* snapshot) noexcept : mSnapshot(snapshot) {}
+		void Release() noexcept { if (mSnapshot) mSnapshot->mReaders.fetch_sub(1, std::memory_order_release); mSnapshot = nullptr; }
+
+		InputSnapshot const* mSnapshot = nullptr;
+	};
+
 	template <typename USER_DATA>
 	struct InputInformation : USER_DATA
 	{
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Common.h"
+
+namespace libgameinput
+{
+	struct KeyRepeatSettings
+	{
+		Seconds Delay{ 0.5 }; /// from the press to the first repeat
+		Seconds Interval{ 1.0 / 30.0 }; /// between repeats
+		/// Every repeat divides the interval by this, down to `MinInterval`; 1 repeats at a constant rate
+		double Acceleration = 1.0;
+		Seconds MinInterval{ 1.0 / 60.0 };
+	};
+
+	/// Generates repeats for held keys, identified by indices below the size given to `Resize`. The keys are kept in a
+	/// timer wheel of `WheelSlots` slots of `SlotDuration` each, so `Advance` only visits the slots that passed since the
+	/// last call, and in them only the held keys: keys that are not held cost nothing, and held keys only when they are
+	/// close to due. Keys due further than a revolution ahead stay in their slot, and are skipped when it comes around.
+	struct KeyRepeatScheduler
+	{
+		static constexpr size_t WheelSlots = 64;
+		static constexpr Seconds SlotDuration{ 1.0 / 128.0 };
+
+		/// Changes take effect on the next press or repeat
+		KeyRepeatSettings Settings;
+
+		/// Releases all keys
+		void Resize(size_t key_count);
+		void Press(uint32_t key, TimePoint now);
+		void Release(uint32_t key);
+		/// Fires the repeats that are due by `now`; if more than one repeat of a key is due (e.g. after a long frame),
+		/// all of them are counted
+		void Advance(TimePoint now);
+
+		bool IsHeld(uint32_t key) const { return key < mKeys.size() && mKeys[key].Slot != None; }
+		/// Repeats since the key was pressed
+		int RepeatCount(uint32_t key) const { return IsHeld(key) ? mKeys[key].Count : 0; }
+		/// Whether the key repeated in the last `Advance`
+		bool WasRepeated(uint32_t key) const { return IsHeld(key) && mKeys[key].RepeatedIn == mGeneration; }
+		auto RepeatedKeys() const -> std::span<uint32_t const> { return mRepeated; }
+		auto HeldCount() const -> size_t { return mHeldCount; }
+
+	private:
+
+		static constexpr uint32_t None = ~uint32_t{};
+
+		struct KeyState
+		{
+			TimePoint Due{};
+			Seconds Interval{};
+			uint32_t Slot = None; /// None if the key is not held
+			uint32_t Next = None; /// in the slot's list
+			uint32_t Prev = None;
+			int Count = 0;
+			uint64_t RepeatedIn = 0; /// the `Advance` generation of the last repeat
+		};
+
+		static auto TickOf(TimePoint time) -> int64_t;
+		void Schedule(uint32_t key);
+		void Unlink(uint32_t key);
+
+		std::vector<KeyState> mKeys;
+		std::array<uint32_t, WheelSlots> mSlots{}; /// heads of the slot lists
+		int64_t mTick = 0; /// slots before this tick are done; this one may hold keys due later in the tick
+		bool mStarted = false;
+		uint64_t mGeneration = 1;
+		std::vector<uint32_t> mRepeated;
+		size_t mHeldCount = 0;
+	};
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Common.h"
+
+namespace libgameinput
+{
+	struct MouseMotionSample
+	{
+		TimePoint Time{}; /// of the last motion event merged into this sample
+		vec2 Delta{}; /// motion since the previous sample
+	};
+
+	/// Accumulates relative mouse motion over a frame. High-rate mice can send thousands of motion events per frame, so
+	/// every event costs a few additions: the total is kept with sub-pixel precision, events without motion are dropped,
+	/// and events closer together than `PathResolution` are merged into one sample of the frame's motion path. If the
+	/// path still fills up, neighbouring samples are merged and the resolution is halved for the rest of the frame, so
+	/// no displacement is ever lost, only timing detail.
+	struct MouseMotionAccumulator
+	{
+		static constexpr size_t MaxPathSamples = 256;
+
+		/// Changes take effect on the next frame
+		Seconds PathResolution{ 0.0005 };
+
+		void AddMotion(vec2 delta, TimePoint time);
+		/// Starts a new frame; the current totals become the last frame's
+		void NewFrame();
+
+		auto Total() const -> vec2 { return mTotal; }
+		auto LastFrameTotal() const -> vec2 { return mLastFrameTotal; }
+		/// This frame's motion, oldest first; the deltas add up to `Total()`
+		auto Path() const -> std::span<MouseMotionSample const> { return std::span{ mPath }.first(mPathSize); }
+		/// Motion events received this frame, including the ones without motion
+		auto EventCount() const -> size_t { return mEventCount; }
+
+	private:
+
+		vec2 mTotal{};
+		vec2 mLastFrameTotal{};
+		std::array<MouseMotionSample, MaxPathSamples> mPath{};
+		size_t mPathSize = 0;
+		TimePoint mSampleStart{}; /// of the newest path sample
+		Seconds mResolution = PathResolution; /// doubled every time the path fills up this frame
+		size_t mEventCount = 0;
+	};
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Common.h"
+
+#include <memory>
+
+namespace libgameinput
+{
+	struct IInputDevice;
+
+	/// How an intent combines with the others of the same priority on the same output
+	enum class OutputBlend
+	{
+		Replace, /// the last one posted wins
+		Max, /// per component
+		Add, /// per component
+		Multiply,
+	};
+
+	struct OutputIntent
+	{
+		vec3 Value{};
+		/// Only the intents of the highest priority on an output are blended; the rest are ignored while they are there
+		int Priority = 0;
+		OutputBlend Blend = OutputBlend::Max;
+		/// Counted from the first flush that sees the intent; 0 means until the next flush, so intents posted every frame
+		/// last as long as they are posted
+		Seconds Duration{ 0 };
+		/// A non-zero source replaces its own earlier intent on the same output, instead of adding another one, and can be
+		/// cancelled with `Cancel`
+		uint32_t Source = 0;
+	};
+
+	/// Collects output intents (rumble, LEDs, etc.) posted at any rate, and writes them to the devices once per `Flush`:
+	/// the intents on each output are merged into one value, writes that would not change what the device has are dropped,
+	/// outputs that nothing asks for anymore are reset once, and the writes to each device are bracketed with its
+	/// `BeginOutputBatch`/`EndOutputBatch`, so backends can send them as one report. Merged values of vibration, color and
+	/// flag outputs are clamped to [0, 1], and flags are rounded to 0 or 1.
+	///
+	/// Devices must outlive their intents; see `RemoveDevice`.
+	struct OutputScheduler
+	{
+		/// Changes of any component smaller than this are not written
+		double Tolerance = 1.0 / 1024.0;
+
+		/// Intents for outputs the device does not have are ignored
+		void Post(IInputDevice& device, size_t output, OutputIntent const& intent);
+		void Cancel(uint32_t source);
+		/// Cancels all intents, so the written outputs are reset on the next flush
+		void CancelAll();
+		/// Forgets the intents and written state of a device, without writing to it
+		void RemoveDevice(IInputDevice const* device);
+		/// Removes all devices not in `devices`
+		void RemoveDevicesExcept(std::span<std::unique_ptr<IInputDevice> const> devices);
+
+		void Flush(TimePoint now);
+
+		/// The merged value last written to the output, if it was written and not reset since
+		auto WrittenValue(IInputDevice const* device, size_t output) const -> vec3 const*;
+		auto IntentCount() const -> size_t { return mIntents.size(); }
+		/// Outputs written or reset by the last `Flush`
+		auto WritesLastFlush() const -> size_t { return mWritesLastFlush; }
+
+	private:
+
+		struct Intent
+		{
+			IInputDevice* Device = nullptr;
+			size_t Output = 0;
+			OutputIntent Request;
+			TimePoint Expires{}; /// for intents with a `Duration`; set by the first flush
+			uint64_t Sequence = 0;
+		};
+
+		struct OutputState
+		{
+			IInputDevice* Device = nullptr;
+			size_t Output = 0;
+			vec3 Value{};
+			bool Written = false;
+			bool Wanted = false; /// during a flush
+		};
+
+		struct Write
+		{
+			IInputDevice* Device = nullptr;
+			size_t Output = 0;
+			vec3 Value{};
+			bool Reset = false;
+		};
+
+		auto StateOf(IInputDevice* device, size_t output) -> OutputState&;
+		static auto Merge(std::span<Intent const> intents) -> vec3;
+
+		std::vector<Intent> mIntents;
+		std::vector<OutputState> mStates; /// sorted by device and output
+		std::vector<Write> mWrites; /// kept to not allocate every flush
+		uint64_t mSequence = 0;
+		size_t mWritesLastFlush = 0;
+	};
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Common.h"
+
+#include <atomic>
+#include <optional>
+
+namespace libgameinput
+{
+	struct Pose
+	{
+		TimePoint Time{};
+		vec3 Position{};
+		quat Rotation{};
+	};
+
+	/// A ring of timestamped poses, written by one thread (e.g. the tracking thread of a backend) and read by any number
+	/// of others without locks or allocations. Every slot is guarded by a sequence number, so readers detect slots that
+	/// are being overwritten, and treat them as already gone.
+	struct PoseHistory
+	{
+		static constexpr size_t Capacity = 64;
+
+		/// Samples must be recorded in time order; samples older than the newest one are ignored
+		void Record(Pose const& pose);
+		/// Forgets all samples; only the recording thread may call this
+		void Clear();
+
+		/// Interpolates (slerp for rotations) between the samples around `time`. Past the newest sample, extrapolates with the
+		/// velocity between the newest two, by at most `MaxExtrapolation`; before the oldest, returns the oldest.
+		/// Returns nullopt if nothing was recorded.
+		auto At(TimePoint time) const -> std::optional<Pose>;
+		auto Newest() const -> std::optional<Pose>;
+
+		/// Should be set before recording starts
+		Seconds MaxExtrapolation{ 0.05 };
+
+	private:
+
+		struct Slot
+		{
+			std::atomic<uint64_t> Version = 0; /// 2 * sample + 1 while being written, 2 * sample + 2 when done
+			std::atomic<int64_t> Time = 0;
+			std::array<std::atomic<double>, 7> Values{}; /// position xyz, rotation wxyz
+		};
+
+		std::array<Slot, Capacity> mSlots;
+		std::atomic<uint64_t> mCount = 0; /// samples ever recorded
+		std::atomic<uint64_t> mFirst = 0; /// samples before this were cleared
+
+		bool ReadSample(uint64_t sample, Pose& into) const;
+		auto OldestReadableSample(uint64_t count) const -> uint64_t;
+	};
+}
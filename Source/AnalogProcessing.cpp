@@ -0,0 +1,298 @@
+#include "AnalogProcessing.h"
+#include "InputDevice.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define LIBGAMEINPUT_ANALOG_AVX 1
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIBGAMEINPUT_ANALOG_SSE2 1
+#endif
+
+namespace libgameinput
+{
+	auto AnalogChannelSettings::FromProperties(InputProperties const& props) -> AnalogChannelSettings
+	{
+		AnalogChannelSettings result;
+		if (props.Flags.contains(InputFlags::HasDeadzone))
+		{
+			result.DeadZoneMin = props.DeadZoneMin;
+			result.DeadZoneMax = props.DeadZoneMax;
+		}
+		else
+			result.DeadZoneMin = result.DeadZoneMax = props.NeutralValue;
+		result.MinValue = props.MinValue;
+		result.NeutralValue = props.NeutralValue;
+		result.MaxValue = props.MaxValue;
+		result.ValueFunction = props.ValueFunction;
+		return result;
+	}
+
+	auto AnalogProcessor::AddChannel(AnalogChannelSettings const& settings) -> size_t
+	{
+		const auto channel = mChannelCount++;
+		const auto padded_size = (mChannelCount + Lanes - 1) / Lanes * Lanes;
+		for (auto array : { &mRaw, &mPositiveOrigin, &mPositiveScale, &mNegativeOrigin, &mNegativeScale, &mLinear, &mQuadratic, &mCubic, &mResult })
+			array->resize(padded_size, 0.0f);
+		Configure(channel, settings);
+		return channel;
+	}
+
+	void AnalogProcessor::Configure(size_t channel, AnalogChannelSettings const& settings)
+	{
+		if (channel >= mChannelCount)
+			return;
+
+		const auto positive_origin = std::max(settings.NeutralValue, settings.DeadZoneMax);
+		const auto negative_origin = std::min(settings.NeutralValue, settings.DeadZoneMin);
+		const auto positive_range = settings.MaxValue - positive_origin;
+		const auto negative_range = negative_origin - settings.MinValue;
+
+		mPositiveOrigin[channel] = float(positive_origin);
+		mNegativeOrigin[channel] = float(negative_origin);
+		mPositiveScale[channel] = positive_range > 0 && std::isfinite(positive_range) ? float(1.0 / positive_range) : 0.0f;
+		mNegativeScale[channel] = negative_range > 0 && std::isfinite(negative_range) ? float(1.0 / negative_range) : 0.0f;
+
+		double linear = 0, quadratic = 0, cubic = 0;
+		switch (settings.ValueFunction)
+		{
+		case InputValueFunction::Linear: linear = 1; break;
+		case InputValueFunction::Quadratic: quadratic = 1; break;
+		case InputValueFunction::Cubic: cubic = 1; break;
+		case InputValueFunction::SCurve: linear = 1.5; cubic = -0.5; break;
+		}
+
+		const auto gain = settings.Sensitivity * (settings.Inverted ? -1.0 : 1.0);
+		mLinear[channel] = float(linear * gain);
+		mQuadratic[channel] = float(quadratic * gain);
+		mCubic[channel] = float(cubic * gain);
+	}
+
+	void AnalogProcessor::Clear()
+	{
+		mChannelCount = 0;
+		for (auto array : { &mRaw, &mPositiveOrigin, &mPositiveScale, &mNegativeOrigin, &mNegativeScale, &mLinear, &mQuadratic, &mCubic, &mResult })
+			array->clear();
+	}
+
+	void AnalogProcessor::Process()
+	{
+		ProcessLanes(0, mRaw.size());
+	}
+
+	void AnalogProcessor::Process(std::span<uint32_t const> channels)
+	{
+		auto processed = InvalidIndex;
+		for (auto channel : channels)
+		{
+			if (channel >= mChannelCount)
+				continue;
+			const auto begin = channel / Lanes * Lanes;
+			if (begin != processed)
+				ProcessLanes(begin, begin + Lanes);
+			processed = begin;
+		}
+	}
+
+	void AnalogProcessor::ProcessLanes(size_t begin, size_t end)
+	{
+#if defined(LIBGAMEINPUT_ANALOG_AVX)
+		const auto zero = _mm256_setzero_ps();
+		const auto one = _mm256_set1_ps(1.0f);
+		const auto minus_one = _mm256_set1_ps(-1.0f);
+		const auto abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+		for (size_t i = begin; i < end; i += 8)
+		{
+			const auto raw = _mm256_loadu_ps(&mRaw[i]);
+			const auto positive_origin = _mm256_loadu_ps(&mPositiveOrigin[i]);
+			const auto negative_origin = _mm256_loadu_ps(&mNegativeOrigin[i]);
+			const auto positive = _mm256_mul_ps(_mm256_sub_ps(raw, positive_origin), _mm256_loadu_ps(&mPositiveScale[i]));
+			const auto negative = _mm256_mul_ps(_mm256_sub_ps(raw, negative_origin), _mm256_loadu_ps(&mNegativeScale[i]));
+			auto x = _mm256_blendv_ps(zero, positive, _mm256_cmp_ps(raw, positive_origin, _CMP_GT_OQ));
+			x = _mm256_blendv_ps(x, negative, _mm256_cmp_ps(raw, negative_origin, _CMP_LT_OQ));
+			x = _mm256_max_ps(minus_one, _mm256_min_ps(one, x));
+			const auto ax = _mm256_and_ps(x, abs_mask);
+			auto curve = _mm256_add_ps(_mm256_loadu_ps(&mQuadratic[i]), _mm256_mul_ps(ax, _mm256_loadu_ps(&mCubic[i])));
+			curve = _mm256_add_ps(_mm256_loadu_ps(&mLinear[i]), _mm256_mul_ps(ax, curve));
+			_mm256_storeu_ps(&mResult[i], _mm256_mul_ps(x, curve));
+		}
+#elif defined(LIBGAMEINPUT_ANALOG_SSE2)
+		const auto one = _mm_set1_ps(1.0f);
+		const auto minus_one = _mm_set1_ps(-1.0f);
+		const auto abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		for (size_t i = begin; i < end; i += 4)
+		{
+			const auto raw = _mm_loadu_ps(&mRaw[i]);
+			const auto positive_origin = _mm_loadu_ps(&mPositiveOrigin[i]);
+			const auto negative_origin = _mm_loadu_ps(&mNegativeOrigin[i]);
+			const auto positive = _mm_mul_ps(_mm_sub_ps(raw, positive_origin), _mm_loadu_ps(&mPositiveScale[i]));
+			const auto negative = _mm_mul_ps(_mm_sub_ps(raw, negative_origin), _mm_loadu_ps(&mNegativeScale[i]));
+			/// The masks are disjoint, so the two selects can be merged with an or
+			auto x = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(raw, positive_origin), positive), _mm_and_ps(_mm_cmplt_ps(raw, negative_origin), negative));
+			x = _mm_max_ps(minus_one, _mm_min_ps(one, x));
+			const auto ax = _mm_and_ps(x, abs_mask);
+			auto curve = _mm_add_ps(_mm_loadu_ps(&mQuadratic[i]), _mm_mul_ps(ax, _mm_loadu_ps(&mCubic[i])));
+			curve = _mm_add_ps(_mm_loadu_ps(&mLinear[i]), _mm_mul_ps(ax, curve));
+			_mm_storeu_ps(&mResult[i], _mm_mul_ps(x, curve));
+		}
+#else
+		for (size_t i = begin; i < end; ++i)
+		{
+			const auto raw = mRaw[i];
+			float x = 0.0f;
+			if (raw > mPositiveOrigin[i])
+				x = (raw - mPositiveOrigin[i]) * mPositiveScale[i];
+			else if (raw < mNegativeOrigin[i])
+				x = (raw - mNegativeOrigin[i]) * mNegativeScale[i];
+			x = std::clamp(x, -1.0f, 1.0f);
+			const auto ax = std::abs(x);
+			mResult[i] = x * (mLinear[i] + ax * (mQuadratic[i] + ax * mCubic[i]));
+		}
+#endif
+	}
+
+	auto StickProcessor::AddStick(StickDeadZoneSettings const& settings) -> size_t
+	{
+		const auto stick = mStickCount++;
+		const auto padded_size = (mStickCount + Lanes - 1) / Lanes * Lanes;
+		for (auto array : { &mRawX, &mRawY, &mInner, &mInverseRange, &mOuter, &mAnti, &mAxialWeight, &mScaledWeight, &mSlope, &mResultX, &mResultY })
+			array->resize(padded_size, 0.0f);
+		Configure(stick, settings);
+		return stick;
+	}
+
+	void StickProcessor::Configure(size_t stick, StickDeadZoneSettings const& settings)
+	{
+		if (stick >= mStickCount)
+			return;
+
+		const auto inner = std::clamp(settings.InnerDeadZone, 0.0, 0.99);
+		const auto outer = std::clamp(settings.OuterDeadZone, inner + 0.01, 1.0);
+		mInner[stick] = float(inner);
+		mOuter[stick] = float(outer);
+		mInverseRange[stick] = float(1.0 / (outer - inner));
+		mAnti[stick] = float(std::clamp(settings.AntiDeadZone, 0.0, 0.99));
+		mAxialWeight[stick] = settings.Type == StickDeadZoneType::Axial ? 1.0f : 0.0f;
+		mScaledWeight[stick] = settings.Type == StickDeadZoneType::Radial ? 0.0f : 1.0f;
+		mSlope[stick] = settings.Type == StickDeadZoneType::Hybrid ? float(inner) : 0.0f;
+	}
+
+	void StickProcessor::Clear()
+	{
+		mStickCount = 0;
+		for (auto array : { &mRawX, &mRawY, &mInner, &mInverseRange, &mOuter, &mAnti, &mAxialWeight, &mScaledWeight, &mSlope, &mResultX, &mResultY })
+			array->clear();
+	}
+
+	/// For every stick, both the radial (plain, scaled or hybrid) and the axial results are computed, and blended by the type weights:
+	///		m = |raw|
+	///		radial magnitude = lerp(m < inner ? 0 : m >= outer ? 1 : m, saturate((m - inner) / (outer - inner)), scaled weight)
+	///		hybrid: every axis of the radial result gets a deadzone of slope * |other axis|, rescaled to keep the range
+	///		anti-deadzone: non-zero magnitudes are remapped from [0, 1] to [anti, 1]
+	///		axial: every axis gets the scaled deadzone and anti-deadzone on its own
+	void StickProcessor::Process()
+	{
+		ProcessLanes(0, mRawX.size());
+	}
+
+	void StickProcessor::Process(std::span<uint32_t const> sticks)
+	{
+		auto processed = InvalidIndex;
+		for (auto stick : sticks)
+		{
+			if (stick >= mStickCount)
+				continue;
+			const auto begin = stick / Lanes * Lanes;
+			if (begin != processed)
+				ProcessLanes(begin, begin + Lanes);
+			processed = begin;
+		}
+	}
+
+	void StickProcessor::ProcessLanes(size_t begin, size_t end)
+	{
+#if defined(LIBGAMEINPUT_ANALOG_AVX) || defined(LIBGAMEINPUT_ANALOG_SSE2)
+		const auto zero = _mm_setzero_ps();
+		const auto one = _mm_set1_ps(1.0f);
+		const auto abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		const auto sign_mask = _mm_castsi128_ps(_mm_set1_epi32(int(0x80000000)));
+		const auto saturate = [&](__m128 v) { return _mm_max_ps(zero, _mm_min_ps(one, v)); };
+		const auto select = [](__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); };
+
+		for (size_t i = begin; i < end; i += 4)
+		{
+			const auto x = _mm_loadu_ps(&mRawX[i]);
+			const auto y = _mm_loadu_ps(&mRawY[i]);
+			const auto inner = _mm_loadu_ps(&mInner[i]);
+			const auto inverse_range = _mm_loadu_ps(&mInverseRange[i]);
+			const auto anti = _mm_loadu_ps(&mAnti[i]);
+			const auto slope = _mm_loadu_ps(&mSlope[i]);
+
+			/// Radial
+			const auto m = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+			const auto plain = _mm_andnot_ps(_mm_cmplt_ps(m, inner), select(_mm_cmpge_ps(m, _mm_loadu_ps(&mOuter[i])), one, m));
+			const auto scaled = saturate(_mm_mul_ps(_mm_sub_ps(m, inner), inverse_range));
+			const auto radial = _mm_add_ps(plain, _mm_mul_ps(_mm_loadu_ps(&mScaledWeight[i]), _mm_sub_ps(scaled, plain)));
+			const auto to_radial = _mm_and_ps(_mm_cmpgt_ps(m, zero), _mm_div_ps(radial, m));
+			auto rx = _mm_mul_ps(x, to_radial);
+			auto ry = _mm_mul_ps(y, to_radial);
+
+			/// Hybrid
+			const auto rx_abs = _mm_and_ps(rx, abs_mask);
+			const auto ry_abs = _mm_and_ps(ry, abs_mask);
+			const auto dzx = _mm_mul_ps(slope, ry_abs);
+			const auto dzy = _mm_mul_ps(slope, rx_abs);
+			rx = _mm_or_ps(_mm_and_ps(rx, sign_mask), _mm_div_ps(_mm_max_ps(zero, _mm_sub_ps(rx_abs, dzx)), _mm_sub_ps(one, dzx)));
+			ry = _mm_or_ps(_mm_and_ps(ry, sign_mask), _mm_div_ps(_mm_max_ps(zero, _mm_sub_ps(ry_abs, dzy)), _mm_sub_ps(one, dzy)));
+
+			/// Radial anti-deadzone
+			const auto m2 = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)));
+			const auto anti_scale = _mm_and_ps(_mm_cmpgt_ps(m2, zero), _mm_div_ps(_mm_add_ps(anti, _mm_mul_ps(_mm_sub_ps(one, anti), m2)), m2));
+			rx = _mm_mul_ps(rx, anti_scale);
+			ry = _mm_mul_ps(ry, anti_scale);
+
+			/// Axial
+			const auto axial = [&](__m128 v) {
+				const auto scaled_axis = saturate(_mm_mul_ps(_mm_sub_ps(_mm_and_ps(v, abs_mask), inner), inverse_range));
+				const auto with_anti = _mm_and_ps(_mm_cmpgt_ps(scaled_axis, zero), _mm_add_ps(anti, _mm_mul_ps(_mm_sub_ps(one, anti), scaled_axis)));
+				return _mm_or_ps(_mm_and_ps(v, sign_mask), with_anti);
+			};
+			const auto axial_weight = _mm_loadu_ps(&mAxialWeight[i]);
+			_mm_storeu_ps(&mResultX[i], _mm_add_ps(rx, _mm_mul_ps(axial_weight, _mm_sub_ps(axial(x), rx))));
+			_mm_storeu_ps(&mResultY[i], _mm_add_ps(ry, _mm_mul_ps(axial_weight, _mm_sub_ps(axial(y), ry))));
+		}
+#else
+		for (size_t i = begin; i < end; ++i)
+		{
+			const auto x = mRawX[i], y = mRawY[i];
+			const auto inner = mInner[i], anti = mAnti[i], slope = mSlope[i];
+
+			const auto m = std::sqrt(x * x + y * y);
+			const auto plain = m < inner ? 0.0f : m >= mOuter[i] ? 1.0f : m;
+			const auto scaled = std::clamp((m - inner) * mInverseRange[i], 0.0f, 1.0f);
+			const auto radial = plain + mScaledWeight[i] * (scaled - plain);
+			const auto to_radial = m > 0 ? radial / m : 0.0f;
+			auto rx = x * to_radial, ry = y * to_radial;
+
+			const auto dzx = slope * std::abs(ry), dzy = slope * std::abs(rx);
+			rx = std::copysign(std::max(0.0f, std::abs(rx) - dzx) / (1.0f - dzx), rx);
+			ry = std::copysign(std::max(0.0f, std::abs(ry) - dzy) / (1.0f - dzy), ry);
+
+			const auto m2 = std::sqrt(rx * rx + ry * ry);
+			const auto anti_scale = m2 > 0 ? (anti + (1.0f - anti) * m2) / m2 : 0.0f;
+			rx *= anti_scale;
+			ry *= anti_scale;
+
+			const auto axial = [&](float v) {
+				const auto scaled_axis = std::clamp((std::abs(v) - inner) * mInverseRange[i], 0.0f, 1.0f);
+				return std::copysign(scaled_axis > 0 ? anti + (1.0f - anti) * scaled_axis : 0.0f, v);
+			};
+			mResultX[i] = rx + mAxialWeight[i] * (axial(x) - rx);
+			mResultY[i] = ry + mAxialWeight[i] * (axial(y) - ry);
+		}
+#endif
+	}
+}
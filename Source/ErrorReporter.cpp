@@ -0,0 +1,210 @@
+#include "ErrorReporter.h"
+
+#include <algorithm>
+
+/// `Reporter`'s constructor and `IErrorReporter::PerformReport` are provided by the application;
+/// this file only implements structured, rate-limited and deferred reporting on top of them
+
+namespace libgameinput
+{
+	namespace
+	{
+		auto SteadyNow() noexcept -> int64_t
+		{
+			return std::chrono::steady_clock::now().time_since_epoch().count();
+		}
+
+		auto SteadyTicks(std::chrono::milliseconds interval) noexcept -> int64_t
+		{
+			return std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval).count();
+		}
+	}
+
+	auto StructuredReport::NewValue(std::string_view name, ValueKind kind) noexcept -> ReportValue*
+	{
+		if (ValueCount == MaxValues)
+		{
+			Truncated = true;
+			return nullptr;
+		}
+		auto& value = Values[ValueCount++];
+		value.Name = name;
+		value.Kind = kind;
+		return &value;
+	}
+
+	StructuredReport& StructuredReport::Value(std::string_view name, std::string_view text) noexcept
+	{
+		if (auto value = NewValue(name, ValueKind::InlineText))
+		{
+			const auto size = std::min(text.size(), InlineTextCapacity - InlineTextSize);
+			Truncated |= size < text.size();
+			std::copy_n(text.data(), size, InlineText.data() + InlineTextSize);
+			value->InlineText = { InlineTextSize, (uint16_t)size };
+			InlineTextSize += (uint16_t)size;
+		}
+		return *this;
+	}
+
+	auto StructuredReport::ValueText(ReportValue const& value) const -> std::string_view
+	{
+		switch (value.Kind)
+		{
+		case ValueKind::StaticText: return value.StaticText;
+		case ValueKind::InlineText: return { InlineText.data() + value.InlineText.Offset, value.InlineText.Size };
+		default: return {};
+		}
+	}
+
+	auto StructuredReport::FormatValue(ReportValue const& value) const -> std::string
+	{
+		switch (value.Kind)
+		{
+		case ValueKind::Bool: return value.Bool ? "true" : "false";
+		case ValueKind::Signed: return std::format("{}", value.Signed);
+		case ValueKind::Unsigned: return std::format("{}", value.Unsigned);
+		case ValueKind::Float: return std::format("{}", value.Float);
+		case ValueKind::Pointer: return std::format("{}", value.Pointer);
+		case ValueKind::StaticText:
+		case ValueKind::InlineText: return std::string{ ValueText(value) };
+		}
+		return {};
+	}
+
+	auto StructuredReport::ToReporter() const -> Reporter
+	{
+		Reporter result{ *Target, Type };
+		result.MessageLines.push_back(std::string{ Message });
+		for (size_t i = 0; i < ValueCount; ++i)
+			result.AdditionalInfoLines.push_back({ std::string{ Values[i].Name }, FormatValue(Values[i]) });
+		result.Value("Location", std::format("{}({}): {}", Location.file_name(), Location.line(), Location.function_name()));
+		if (Truncated)
+			result.AdditionalInfoLines.push_back({ "Note", "Some values did not fit in the report and were truncated" });
+		return result;
+	}
+
+	void StructuredReport::Perform() const
+	{
+		if (Target && Target->WantsReport(Type))
+			Target->PerformStructuredReport(*this);
+	}
+
+	void IErrorReporter::PerformStructuredReport(StructuredReport const& report) const
+	{
+		PerformReport(report.ToReporter());
+	}
+
+	IErrorReporter::~IErrorReporter()
+	{
+		StopDeferredReporting();
+	}
+
+	bool IErrorReporter::ClaimSiteReport(ReportSite& site) const noexcept
+	{
+		/// Whoever moves the next report time forward from the due time it read gets to report, so a report is claimed and 
+		/// the site rate-limited in one step, and concurrent callers that read the same due time cannot both report
+		const auto now = SteadyNow();
+		auto next = site.mNextReportTime.load(std::memory_order_relaxed);
+		if (now < next)
+			return false;
+		if (!site.mNextReportTime.compare_exchange_strong(next, now + SteadyTicks(site.MinInterval), std::memory_order_acquire, std::memory_order_relaxed))
+			return false;
+		site.mArmed.store(false, std::memory_order_relaxed);
+		return true;
+	}
+
+	void IErrorReporter::SubmitSiteReport(ReportSite& site, uint64_t occurrence, StructuredReport const& report) const
+	{
+		if (!mDeferredReporting.load(std::memory_order_acquire))
+		{
+			PerformSiteReport(site, occurrence, report);
+			return;
+		}
+
+		auto pending = new PendingReport{ nullptr, &site, occurrence, report };
+		pending->Next = mPendingReports.load(std::memory_order_relaxed);
+		while (!mPendingReports.compare_exchange_weak(pending->Next, pending, std::memory_order_release, std::memory_order_relaxed))
+			;
+	}
+
+	void IErrorReporter::PerformSiteReport(ReportSite& site, uint64_t occurrence, StructuredReport const& report) const
+	{
+		{
+			std::lock_guard lock{ mDeferredMutex };
+			if (std::ranges::find(mSites, &site) == mSites.end())
+				mSites.push_back(&site);
+		}
+		const auto previous = site.mReportedOccurrences.exchange(occurrence, std::memory_order_relaxed);
+		if (!WantsReport(site.Type))
+			return;
+
+		auto reporter = report.ToReporter();
+		if (occurrence > previous + 1)
+			reporter.Value("Occurrences since last report", occurrence - previous);
+		reporter.Perform();
+	}
+
+	void IErrorReporter::StartDeferredReporting(std::chrono::milliseconds poll_interval)
+	{
+		if (mDeferredThread.joinable())
+			return;
+
+		mStopDeferred = false;
+		mDeferredReporting.store(true, std::memory_order_release);
+		mDeferredThread = std::thread{ [this, poll_interval] {
+			std::unique_lock lock{ mDeferredMutex };
+			while (!mStopDeferred)
+			{
+				lock.unlock();
+				PerformPendingReports();
+				RearmDueSites();
+				lock.lock();
+				mDeferredWake.wait_for(lock, poll_interval, [this] { return mStopDeferred; });
+			}
+		} };
+	}
+
+	void IErrorReporter::StopDeferredReporting()
+	{
+		if (!mDeferredThread.joinable())
+			return;
+
+		mDeferredReporting.store(false, std::memory_order_release);
+		{
+			std::lock_guard lock{ mDeferredMutex };
+			mStopDeferred = true;
+		}
+		mDeferredWake.notify_all();
+		mDeferredThread.join();
+
+		/// Reports submitted right before the switch may still be in the queue
+		PerformPendingReports();
+	}
+
+	void IErrorReporter::PerformPendingReports()
+	{
+		auto pending = mPendingReports.exchange(nullptr, std::memory_order_acquire);
+
+		/// The stack is newest first; report in submission order
+		PendingReport* in_order = nullptr;
+		while (pending)
+			in_order = std::exchange(pending, std::exchange(pending->Next, in_order));
+
+		while (in_order)
+		{
+			std::unique_ptr<PendingReport> report{ std::exchange(in_order, in_order->Next) };
+			PerformSiteReport(*report->Site, report->Occurrence, report->Report);
+		}
+	}
+
+	void IErrorReporter::RearmDueSites()
+	{
+		const auto now = SteadyNow();
+		std::lock_guard lock{ mDeferredMutex };
+		for (auto site : mSites)
+		{
+			if (!site->mArmed.load(std::memory_order_relaxed) && now >= site->mNextReportTime.load(std::memory_order_relaxed))
+				site->mArmed.store(true, std::memory_order_release);
+		}
+	}
+}
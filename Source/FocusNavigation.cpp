@@ -0,0 +1,377 @@
+#include "FocusNavigation.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace libgameinput
+{
+	FocusNavigator::FocusNavigator(double cell_size)
+		: mCellSize(cell_size > 0 ? cell_size : 64.0)
+	{
+	}
+
+	static auto Normalized(rec2 const& rect) -> rec2
+	{
+		return {
+			{ std::min(rect.p1.x, rect.p2.x), std::min(rect.p1.y, rect.p2.y) },
+			{ std::max(rect.p1.x, rect.p2.x), std::max(rect.p1.y, rect.p2.y) },
+		};
+	}
+
+	auto FocusNavigator::CellOf(double coordinate) const -> int32_t
+	{
+		/// Small enough that ring arithmetic between any two cells cannot overflow
+		constexpr double limit = 1 << 29;
+		return (int32_t)std::clamp(std::floor(coordinate / mCellSize), -limit, limit);
+	}
+
+	auto FocusNavigator::Add(rec2 const& rect) -> size_t
+	{
+		uint32_t index;
+		if (!mFreeWidgets.empty())
+		{
+			index = mFreeWidgets.back();
+			mFreeWidgets.pop_back();
+		}
+		else
+		{
+			index = (uint32_t)mWidgets.size();
+			mWidgets.emplace_back();
+		}
+
+		mWidgets[index] = { rect, true, true };
+		Insert(index);
+		++mCount;
+		return index;
+	}
+
+	void FocusNavigator::Move(size_t widget, rec2 const& rect)
+	{
+		if (widget >= mWidgets.size() || !mWidgets[widget].Alive)
+			return;
+
+		auto& state = mWidgets[widget];
+		const int32_t cells[4]{
+			CellOf(std::min(rect.p1.x, rect.p2.x)), CellOf(std::min(rect.p1.y, rect.p2.y)),
+			CellOf(std::max(rect.p1.x, rect.p2.x)), CellOf(std::max(rect.p1.y, rect.p2.y)),
+		};
+		if (std::equal(cells, cells + 4, state.Cells))
+		{
+			EraseExtents(state.Rect);
+			state.Rect = rect;
+			InsertExtents(state.Rect);
+			UpdateBounds();
+			return;
+		}
+		Erase((uint32_t)widget);
+		state.Rect = rect;
+		Insert((uint32_t)widget);
+	}
+
+	void FocusNavigator::Remove(size_t widget)
+	{
+		if (widget >= mWidgets.size() || !mWidgets[widget].Alive)
+			return;
+
+		Erase((uint32_t)widget);
+		mWidgets[widget].Alive = false;
+		mFreeWidgets.push_back((uint32_t)widget);
+		--mCount;
+	}
+
+	void FocusNavigator::SetEnabled(size_t widget, bool enabled)
+	{
+		if (widget < mWidgets.size())
+			mWidgets[widget].Enabled = enabled;
+	}
+
+	void FocusNavigator::Clear()
+	{
+		mWidgets.clear();
+		mFreeWidgets.clear();
+		mCells.clear();
+		mCount = 0;
+		mRows.clear();
+		mColumns.clear();
+		mLeftEdges.clear();
+		mTopEdges.clear();
+		mRightEdges.clear();
+		mBottomEdges.clear();
+		UpdateBounds();
+	}
+
+	void FocusNavigator::SetCellSize(double cell_size)
+	{
+		mCellSize = cell_size > 0 ? cell_size : mCellSize;
+		mCells.clear();
+		mRows.clear();
+		mColumns.clear();
+		mLeftEdges.clear();
+		mTopEdges.clear();
+		mRightEdges.clear();
+		mBottomEdges.clear();
+		for (uint32_t index = 0; index < mWidgets.size(); ++index)
+		{
+			if (mWidgets[index].Alive)
+				Insert(index);
+		}
+		UpdateBounds();
+	}
+
+	auto FocusNavigator::Rect(size_t widget) const -> rec2 const*
+	{
+		return widget < mWidgets.size() && mWidgets[widget].Alive ? &mWidgets[widget].Rect : nullptr;
+	}
+
+	void FocusNavigator::Insert(uint32_t widget)
+	{
+		auto& state = mWidgets[widget];
+		auto& cells = state.Cells;
+		cells[0] = CellOf(std::min(state.Rect.p1.x, state.Rect.p2.x));
+		cells[1] = CellOf(std::min(state.Rect.p1.y, state.Rect.p2.y));
+		cells[2] = CellOf(std::max(state.Rect.p1.x, state.Rect.p2.x));
+		cells[3] = CellOf(std::max(state.Rect.p1.y, state.Rect.p2.y));
+
+		for (auto y = cells[1]; y <= cells[3]; ++y)
+			for (auto x = cells[0]; x <= cells[2]; ++x)
+				mCells[CellKey(x, y)].push_back(widget);
+		for (auto y = cells[1]; y <= cells[3]; ++y)
+			++mRows[y];
+		for (auto x = cells[0]; x <= cells[2]; ++x)
+			++mColumns[x];
+
+		InsertExtents(state.Rect);
+		UpdateBounds();
+	}
+
+	void FocusNavigator::InsertExtents(rec2 const& rect)
+	{
+		const auto normalized = Normalized(rect);
+		mLeftEdges.insert(normalized.p1.x);
+		mTopEdges.insert(normalized.p1.y);
+		mRightEdges.insert(normalized.p2.x);
+		mBottomEdges.insert(normalized.p2.y);
+	}
+
+	void FocusNavigator::EraseExtents(rec2 const& rect)
+	{
+		const auto normalized = Normalized(rect);
+		mLeftEdges.erase(mLeftEdges.find(normalized.p1.x));
+		mTopEdges.erase(mTopEdges.find(normalized.p1.y));
+		mRightEdges.erase(mRightEdges.find(normalized.p2.x));
+		mBottomEdges.erase(mBottomEdges.find(normalized.p2.y));
+	}
+
+	void FocusNavigator::UpdateBounds()
+	{
+		if (mRows.empty())
+		{
+			mBounds[0] = mBounds[1] = 0;
+			mBounds[2] = mBounds[3] = -1;
+			mContentBounds = {};
+			return;
+		}
+		mBounds[0] = mColumns.begin()->first;
+		mBounds[1] = mRows.begin()->first;
+		mBounds[2] = mColumns.rbegin()->first;
+		mBounds[3] = mRows.rbegin()->first;
+		mContentBounds = { { *mLeftEdges.begin(), *mTopEdges.begin() }, { *mRightEdges.rbegin(), *mBottomEdges.rbegin() } };
+	}
+
+	void FocusNavigator::Erase(uint32_t widget)
+	{
+		auto const& cells = mWidgets[widget].Cells;
+		const auto release = [](std::map<int32_t, uint32_t>& counts, int32_t key) {
+			if (auto it = counts.find(key); it != counts.end() && --it->second == 0)
+				counts.erase(it);
+		};
+		for (auto y = cells[1]; y <= cells[3]; ++y)
+			release(mRows, y);
+		for (auto x = cells[0]; x <= cells[2]; ++x)
+			release(mColumns, x);
+		EraseExtents(mWidgets[widget].Rect);
+
+		for (auto y = cells[1]; y <= cells[3]; ++y)
+		{
+			for (auto x = cells[0]; x <= cells[2]; ++x)
+			{
+				auto it = mCells.find(CellKey(x, y));
+				if (it == mCells.end())
+					continue;
+				auto& bucket = it->second;
+				if (auto found = std::ranges::find(bucket, widget); found != bucket.end())
+				{
+					*found = bucket.back();
+					bucket.pop_back();
+				}
+			}
+		}
+		UpdateBounds();
+	}
+
+	auto FocusNavigator::FindNext(rec2 const& from, vec2 direction, size_t exclude) const -> size_t
+	{
+		const auto length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+		if (mCount == 0 || !(length > 0) || std::isinf(length))
+			return InvalidIndex;
+		direction /= length;
+
+		if (++mQuery == 0)
+		{
+			std::ranges::fill(mVisited, 0u);
+			mQuery = 1;
+		}
+		mVisited.resize(mWidgets.size(), 0u);
+
+		const int32_t origin[4]{ CellOf(from.p1.x), CellOf(from.p1.y), CellOf(from.p2.x), CellOf(from.p2.y) };
+		size_t best = InvalidIndex;
+		double best_score = INFINITY, best_offset = INFINITY;
+
+		size_t seen = 0;
+		/// Widgets not found within `ring - 1` rings of the origin cells are at least `(ring - 1) * cell size` away, and their
+		/// score is at least their distance; rings without occupied cells are skipped, so far away widgets cost nothing
+		/// until the rings reach them
+		for (int32_t ring = 0; ring >= 0; ring = NextOccupiedRing(origin, ring))
+		{
+			if (best != InvalidIndex && best_score < (ring - 1) * mCellSize)
+				break;
+			if (ring > 0 && AheadCovered(origin, ring - 1, from, direction))
+				break;
+
+			/// Only the occupied rows and columns of the ring are visited
+			const int32_t x1 = origin[0] - ring, y1 = origin[1] - ring, x2 = origin[2] + ring, y2 = origin[3] + ring;
+			const auto scan_row = [&](int32_t y) {
+				for (auto it = mColumns.lower_bound(x1); it != mColumns.end() && it->first <= x2; ++it)
+					seen += ScanCell(it->first, y, from, direction, exclude, best, best_score, best_offset);
+			};
+			const auto scan_inner_column = [&](int32_t x) {
+				for (auto it = mRows.upper_bound(y1); it != mRows.end() && it->first < y2; ++it)
+					seen += ScanCell(x, it->first, from, direction, exclude, best, best_score, best_offset);
+			};
+			if (ring == 0)
+			{
+				for (auto it = mRows.lower_bound(y1); it != mRows.end() && it->first <= y2; ++it)
+					scan_row(it->first);
+			}
+			else
+			{
+				if (mRows.contains(y1))
+					scan_row(y1);
+				if (mRows.contains(y2))
+					scan_row(y2);
+				if (mColumns.contains(x1))
+					scan_inner_column(x1);
+				if (mColumns.contains(x2))
+					scan_inner_column(x2);
+			}
+
+			if (seen == mCount)
+				break;
+		}
+		return best;
+	}
+
+	auto FocusNavigator::NextOccupiedRing(int32_t const (&origin)[4], int32_t ring) const -> int32_t
+	{
+		/// A cell of a ring is in one of its edge rows or columns, so a ring whose edge rows and columns are all empty has no occupied cells
+		int64_t next = std::numeric_limits<int64_t>::max();
+		if (auto it = mColumns.lower_bound(origin[0] - ring); it != mColumns.begin())
+			next = std::min(next, int64_t(origin[0]) - std::prev(it)->first);
+		if (auto it = mRows.lower_bound(origin[1] - ring); it != mRows.begin())
+			next = std::min(next, int64_t(origin[1]) - std::prev(it)->first);
+		if (auto it = mColumns.upper_bound(origin[2] + ring); it != mColumns.end())
+			next = std::min(next, int64_t(it->first) - origin[2]);
+		if (auto it = mRows.upper_bound(origin[3] + ring); it != mRows.end())
+			next = std::min(next, int64_t(it->first) - origin[3]);
+		return next == std::numeric_limits<int64_t>::max() ? -1 : int32_t(next);
+	}
+
+	bool FocusNavigator::AheadCovered(int32_t const (&origin)[4], int32_t rings, rec2 const& from, vec2 direction) const
+	{
+		/// Every candidate reaches past the leading edge of `from`, so once the part of the bounds past it is covered, all were seen
+		const auto lead = glm::dot(from.center(), direction) + (std::abs(direction.x) * from.width() + std::abs(direction.y) * from.height()) / 2;
+		const auto reaches_past_lead = [&](int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+			const auto x = direction.x > 0 ? std::min((x2 + 1) * mCellSize, mContentBounds.p2.x) : std::max(x1 * mCellSize, mContentBounds.p1.x);
+			const auto y = direction.y > 0 ? std::min((y2 + 1) * mCellSize, mContentBounds.p2.y) : std::max(y1 * mCellSize, mContentBounds.p1.y);
+			return x1 <= x2 && y1 <= y2 && x * direction.x + y * direction.y > lead;
+		};
+		const int32_t x1 = origin[0] - rings, y1 = origin[1] - rings, x2 = origin[2] + rings, y2 = origin[3] + rings;
+		const auto inner_x1 = std::max(x1, mBounds[0]), inner_x2 = std::min(x2, mBounds[2]);
+		return !reaches_past_lead(mBounds[0], mBounds[1], std::min(x1 - 1, mBounds[2]), mBounds[3])
+			&& !reaches_past_lead(std::max(x2 + 1, mBounds[0]), mBounds[1], mBounds[2], mBounds[3])
+			&& !reaches_past_lead(inner_x1, mBounds[1], inner_x2, std::min(y1 - 1, mBounds[3]))
+			&& !reaches_past_lead(inner_x1, std::max(y2 + 1, mBounds[1]), inner_x2, mBounds[3]);
+	}
+
+	auto FocusNavigator::ScanCell(int32_t x, int32_t y, rec2 const& from, vec2 direction, size_t exclude, size_t& best, double& best_score, double& best_offset) const -> size_t
+	{
+		const auto it = mCells.find(CellKey(x, y));
+		if (it == mCells.end())
+			return 0;
+
+		size_t seen = 0;
+		const vec2 side{ -direction.y, direction.x };
+		const auto extent = [](rec2 const& rect, vec2 axis) { return (std::abs(axis.x) * rect.width() + std::abs(axis.y) * rect.height()) / 2; };
+		const auto from_center = from.center();
+		const auto from_lead = glm::dot(from_center, direction) + extent(from, direction);
+		const auto from_side = glm::dot(from_center, side);
+		const auto from_side_extent = extent(from, side);
+
+		for (auto index : it->second)
+		{
+			if (mVisited[index] == mQuery)
+				continue;
+			mVisited[index] = mQuery;
+			++seen;
+
+			auto const& widget = mWidgets[index];
+			if (!widget.Enabled || index == exclude)
+				continue;
+
+			auto const& rect = widget.Rect;
+			const auto center = rect.center();
+			const auto ahead = glm::dot(center - from_center, direction);
+			if (ahead <= 0 || glm::dot(center, direction) + extent(rect, direction) <= from_lead)
+				continue;
+
+			const auto dx = std::max({ 0.0, from.p1.x - rect.p2.x, rect.p1.x - from.p2.x });
+			const auto dy = std::max({ 0.0, from.p1.y - rect.p2.y, rect.p1.y - from.p2.y });
+			const auto offset = glm::dot(center, side) - from_side;
+			const auto misalignment = std::abs(offset) < from_side_extent + extent(rect, side) ? 0.0 : std::abs(offset);
+			const auto score = std::sqrt(dx * dx + dy * dy) + MisalignmentWeight * misalignment;
+			if (score < best_score || (score == best_score && std::abs(offset) < best_offset))
+			{
+				best = index;
+				best_score = score;
+				best_offset = std::abs(offset);
+			}
+		}
+		return seen;
+	}
+
+	auto FocusNavigator::FindNext(size_t from, UINavigationInput input) const -> size_t
+	{
+		const auto rect = Rect(from);
+		const auto direction = UINavigationInputToDirection(input);
+		if (!rect || (direction.x == 0 && direction.y == 0))
+			return InvalidIndex;
+
+		const auto length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+		const auto steps = std::isinf(length) ? mCount : std::max(size_t(1), size_t(std::lround(length)));
+		const vec2 unit = std::isinf(length)
+			? vec2{ std::isinf(direction.x) ? std::copysign(1.0, direction.x) : 0.0, std::isinf(direction.y) ? std::copysign(1.0, direction.y) : 0.0 }
+			: direction / length;
+
+		auto current = from;
+		for (size_t step = 0; step < steps; ++step)
+		{
+			const auto next = FindNext(mWidgets[current].Rect, unit, current);
+			if (next == InvalidIndex)
+				break;
+			current = next;
+		}
+		return current;
+	}
+}
@@ -0,0 +1,416 @@
+#include "GestureRecognizer.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace libgameinput
+{
+	auto GestureRecognizer::AddTemplate(std::string name, std::span<vec2 const> points, bool rotation_invariant) -> size_t
+	{
+		StrokeTemplate stroke_template{ std::move(name), rotation_invariant };
+		if (!Vectorize(points, rotation_invariant, stroke_template.Vector))
+			return InvalidIndex;
+		mTemplates.push_back(std::move(stroke_template));
+		return mTemplates.size() - 1;
+	}
+
+	auto GestureRecognizer::FindPointer(size_t pointer) -> PointerState*
+	{
+		for (auto& state : mPointers)
+			if (state.Active && state.ID == pointer)
+				return &state;
+		return nullptr;
+	}
+
+	void GestureRecognizer::PointerDown(size_t pointer, vec2 position, TimePoint time)
+	{
+		auto state = FindPointer(pointer);
+		if (!state)
+		{
+			const auto free = std::ranges::find(mPointers, false, &PointerState::Active);
+			if (free == mPointers.end())
+				return;
+			state = &*free;
+		}
+
+		state->Active = true;
+		state->Moved = false;
+		state->HoldRecognized = false;
+		state->Twisted = false;
+		state->ID = pointer;
+		state->DownTime = time;
+		state->DownPosition = position;
+		state->LastPosition = position;
+		state->PathLength = 0;
+		state->Spacing = std::max(Settings.ResampleSpacing, 1e-3);
+		state->DistanceSinceResample = 0;
+		state->Points[0] = position;
+		state->PointCount = 1;
+
+		/// Rotations are tracked between the first two pointers down
+		if (!mTwist.Pointers[0])
+		{
+			const auto other = std::ranges::find_if(mPointers, [&](PointerState const& other) { return other.Active && &other != state; });
+			if (other != mPointers.end())
+			{
+				const auto delta = state->LastPosition - other->LastPosition;
+				mTwist = { { &*other, state }, (other->LastPosition + state->LastPosition) * 0.5, std::atan2(delta.y, delta.x) };
+			}
+		}
+	}
+
+	void GestureRecognizer::PointerMoved(size_t pointer, vec2 position, TimePoint time)
+	{
+		auto state = FindPointer(pointer);
+		if (!state)
+			return;
+
+		AddStrokePoint(*state, position);
+		if (!state->Moved && glm::distance(position, state->DownPosition) > Settings.TapSlop)
+			state->Moved = true;
+		if (state == mTwist.Pointers[0] || state == mTwist.Pointers[1])
+			UpdateTwist(time);
+		Update(time);
+	}
+
+	void GestureRecognizer::PointerUp(size_t pointer, vec2 position, TimePoint time)
+	{
+		auto state = FindPointer(pointer);
+		if (!state)
+			return;
+
+		AddStrokePoint(*state, position);
+		if (!state->Moved && glm::distance(position, state->DownPosition) > Settings.TapSlop)
+			state->Moved = true;
+		if (state == mTwist.Pointers[0] || state == mTwist.Pointers[1])
+		{
+			UpdateTwist(time);
+			mTwist = {};
+		}
+		Update(time);
+		EndStroke(*state, time);
+		state->Active = false;
+	}
+
+	void GestureRecognizer::PointerCancelled(size_t pointer)
+	{
+		auto state = FindPointer(pointer);
+		if (!state)
+			return;
+		if (state == mTwist.Pointers[0] || state == mTwist.Pointers[1])
+			mTwist = {};
+		state->Active = false;
+	}
+
+	void GestureRecognizer::Update(TimePoint now)
+	{
+		for (auto& state : mPointers)
+		{
+			if (!state.Active || state.Moved || state.HoldRecognized || state.Twisted || now - state.DownTime < Settings.HoldMinDuration)
+				continue;
+			state.HoldRecognized = true;
+			mEvents.push_back({ .Type = GestureType::Hold, .Pointer = state.ID, .Time = now, .Position = state.DownPosition });
+		}
+	}
+
+	void GestureRecognizer::UpdateTwist(TimePoint time)
+	{
+		auto const& [first, second] = mTwist.Pointers;
+		const auto delta = second->LastPosition - first->LastPosition;
+		if (delta.x == 0 && delta.y == 0)
+			return;
+
+		/// Positions are in screen space, so a growing angle turns clockwise
+		const auto angle = std::atan2(delta.y, delta.x);
+		mTwist.Accumulated += std::remainder(angle - mTwist.LastAngle, 2.0 * std::numbers::pi);
+		mTwist.LastAngle = angle;
+		if (!mTwist.Recognized)
+		{
+			if (std::abs(mTwist.Accumulated) < Settings.RotateMinAngle)
+				return;
+			mTwist.Recognized = first->Twisted = second->Twisted = true;
+		}
+		if (mTwist.Accumulated == 0)
+			return;
+
+		mEvents.push_back({ .Type = GestureType::Rotate, .Pointer = first->ID, .Time = time, .Position = mTwist.Center, .Angle = mTwist.Accumulated });
+		mTwist.Accumulated = 0;
+	}
+
+	void GestureRecognizer::AddStrokePoint(PointerState& state, vec2 point)
+	{
+		/// Online version of $1's resampling: emit a point every `Spacing` units along the path
+		auto from = state.LastPosition;
+		auto segment = glm::distance(from, point);
+		state.PathLength += segment;
+		state.LastPosition = point;
+
+		while (segment > 0 && state.DistanceSinceResample + segment >= state.Spacing)
+		{
+			if (state.PointCount == MaxStrokePoints)
+			{
+				/// Keep every other point at twice the spacing; the dropped last point was one (old) spacing back
+				for (size_t i = 1; i < MaxStrokePoints / 2; ++i)
+					state.Points[i] = state.Points[i * 2];
+				state.PointCount = MaxStrokePoints / 2;
+				state.DistanceSinceResample += state.Spacing;
+				state.Spacing *= 2;
+				continue;
+			}
+
+			const auto resampled = from + (point - from) * ((state.Spacing - state.DistanceSinceResample) / segment);
+			state.Points[state.PointCount++] = resampled;
+			segment = glm::distance(resampled, point);
+			from = resampled;
+			state.DistanceSinceResample = 0;
+		}
+		state.DistanceSinceResample += segment;
+	}
+
+	void GestureRecognizer::EndStroke(PointerState& state, TimePoint time)
+	{
+		const auto duration = time - state.DownTime;
+		if (state.Twisted)
+			return;
+
+		if (!state.Moved)
+		{
+			if (state.HoldRecognized || duration > Settings.TapMaxDuration)
+				return;
+
+			mEvents.push_back({ .Type = GestureType::Tap, .Pointer = state.ID, .Time = time, .Position = state.DownPosition });
+			if (mLastTapValid && time - mLastTapTime <= Settings.DoubleTapMaxInterval && glm::distance(mLastTapPosition, state.DownPosition) <= Settings.TapSlop * 2)
+			{
+				mEvents.push_back({ .Type = GestureType::DoubleTap, .Pointer = state.ID, .Time = time, .Position = mLastTapPosition });
+				mLastTapValid = false; /// a third tap starts a new double tap
+				return;
+			}
+			mLastTapValid = true;
+			mLastTapTime = time;
+			mLastTapPosition = state.DownPosition;
+			return;
+		}
+
+		const auto delta = state.LastPosition - state.DownPosition;
+		const auto distance = glm::length(delta);
+		if (duration <= Settings.SwipeMaxDuration && distance >= Settings.SwipeMinDistance && distance >= state.PathLength * Settings.SwipeMinStraightness)
+		{
+			/// Positions are in screen space, so y grows downwards
+			const auto type = std::abs(delta.x) >= std::abs(delta.y)
+				? (delta.x < 0 ? GestureType::SwipeLeft : GestureType::SwipeRight)
+				: (delta.y < 0 ? GestureType::SwipeUp : GestureType::SwipeDown);
+			mEvents.push_back({ .Type = type, .Pointer = state.ID, .Time = time, .Position = state.DownPosition, .Direction = delta / distance });
+			return;
+		}
+
+		if (!mTemplates.empty() || Settings.RecognizeCircles)
+		{
+			/// Close the stroke with its last point, which is usually between two resampled ones
+			if (state.DistanceSinceResample > 0)
+			{
+				if (state.PointCount == MaxStrokePoints)
+					--state.PointCount;
+				state.Points[state.PointCount++] = state.LastPosition;
+			}
+			MatchTemplates(state, time);
+		}
+	}
+
+	void GestureRecognizer::MatchTemplates(PointerState const& state, TimePoint time)
+	{
+		const auto points = std::span{ state.Points }.first(state.PointCount);
+
+		/// Strokes are vectorized at most twice, however many templates there are
+		std::array<vec2, TemplatePoints> vectors[2]{};
+		bool vectorized[2]{};
+		bool valid[2]{};
+
+		/// Protractor: the cosine similarity of the vectors, at the best rotation if rotation is allowed
+		const auto similarity = [&](std::array<vec2, TemplatePoints> const& vector, bool rotation_invariant) {
+			const auto kind = size_t(rotation_invariant);
+			if (!vectorized[kind])
+			{
+				vectorized[kind] = true;
+				valid[kind] = Vectorize(points, rotation_invariant, vectors[kind]);
+			}
+			if (!valid[kind])
+				return -1.0;
+
+			double a = 0, b = 0;
+			for (size_t p = 0; p < TemplatePoints; ++p)
+			{
+				auto const& t = vector[p];
+				auto const& g = vectors[kind][p];
+				a += t.x * g.x + t.y * g.y;
+				b += t.x * g.y - t.y * g.x;
+			}
+			return rotation_invariant ? std::hypot(a, b) : a;
+		};
+
+		size_t best = InvalidIndex;
+		double best_score = Settings.MinTemplateScore;
+		for (size_t i = 0; i < mTemplates.size(); ++i)
+		{
+			const auto score = similarity(mTemplates[i].Vector, mTemplates[i].RotationInvariant);
+			if (score >= best_score)
+			{
+				best = i;
+				best_score = score;
+			}
+		}
+
+		/// The built-in circles are drawn clockwise and counterclockwise, and only match closed strokes, so arcs are not circles
+		static const auto circles = [] {
+			std::array<std::array<vec2, TemplatePoints>, 2> result{};
+			std::array<vec2, TemplatePoints + 1> circle{};
+			for (size_t direction = 0; direction < 2; ++direction)
+			{
+				for (size_t i = 0; i < circle.size(); ++i)
+				{
+					const auto angle = 2.0 * std::numbers::pi * double(i) / double(TemplatePoints);
+					circle[i] = { std::cos(angle), direction == 0 ? std::sin(angle) : -std::sin(angle) };
+				}
+				Vectorize(circle, true, result[direction]);
+			}
+			return result;
+		}();
+		double circle_angle = 0;
+		if (Settings.RecognizeCircles && glm::distance(points.front(), points.back()) <= state.PathLength * 0.1)
+		{
+			for (size_t direction = 0; direction < 2; ++direction)
+			{
+				const auto score = similarity(circles[direction], true);
+				if (score >= best_score)
+				{
+					circle_angle = direction == 0 ? 2.0 * std::numbers::pi : -2.0 * std::numbers::pi;
+					best_score = score;
+				}
+			}
+		}
+
+		if (circle_angle != 0)
+			mEvents.push_back({ .Type = GestureType::Circle, .Pointer = state.ID, .Time = time, .Position = state.DownPosition, .Angle = circle_angle, .Score = best_score });
+		else if (best != InvalidIndex)
+			mEvents.push_back({ .Type = GestureType::Template, .Pointer = state.ID, .Template = best, .Time = time, .Position = state.DownPosition, .Score = best_score });
+	}
+
+	bool GestureRecognizer::Vectorize(std::span<vec2 const> points, bool rotation_invariant, std::array<vec2, TemplatePoints>& into)
+	{
+		if (points.size() < 2)
+			return false;
+
+		double length = 0;
+		for (size_t i = 1; i < points.size(); ++i)
+			length += glm::distance(points[i - 1], points[i]);
+		if (length <= 0)
+			return false;
+
+		/// Resample to evenly spaced points along the path
+		const auto spacing = length / double(TemplatePoints - 1);
+		into[0] = points[0];
+		size_t count = 1;
+		double walked = 0;
+		auto from = points[0];
+		for (size_t i = 1; i < points.size() && count < TemplatePoints; )
+		{
+			const auto segment = glm::distance(from, points[i]);
+			if (segment > 0 && walked + segment >= spacing)
+			{
+				from = from + (points[i] - from) * ((spacing - walked) / segment);
+				into[count++] = from;
+				walked = 0;
+			}
+			else
+			{
+				walked += segment;
+				from = points[i++];
+			}
+		}
+		/// Rounding can leave the last point out
+		while (count < TemplatePoints)
+			into[count++] = points.back();
+
+		vec2 centroid{};
+		for (auto const& point : into)
+			centroid += point;
+		centroid /= double(TemplatePoints);
+		for (auto& point : into)
+			point -= centroid;
+
+		if (rotation_invariant)
+		{
+			const auto angle = -std::atan2(into[0].y, into[0].x);
+			const auto cos = std::cos(angle), sin = std::sin(angle);
+			for (auto& point : into)
+				point = { point.x * cos - point.y * sin, point.x * sin + point.y * cos };
+		}
+
+		double magnitude = 0;
+		for (auto const& point : into)
+			magnitude += glm::dot(point, point);
+		magnitude = std::sqrt(magnitude);
+		if (magnitude <= 0)
+			return false;
+		for (auto& point : into)
+			point /= magnitude;
+		return true;
+	}
+
+	GestureDevice::GestureDevice(IInputSystem& sys)
+		: IInputDevice(sys)
+	{
+		mInputProperties = {
+			ButtonInputProperties("Tap", "ControllerGraphics/Gestures/Gesture_Tap.png"),
+			ButtonInputProperties("Double Tap", "ControllerGraphics/Gestures/Gesture_Double_Tap.png"),
+			ButtonInputProperties("Hold", "ControllerGraphics/Gestures/Gesture_Hold.png"),
+			ButtonInputProperties("Swipe Left", "ControllerGraphics/Gestures/Gesture_Swipe_Left.png"),
+			ButtonInputProperties("Swipe Right", "ControllerGraphics/Gestures/Gesture_Swipe_Right.png"),
+			ButtonInputProperties("Swipe Up", "ControllerGraphics/Gestures/Gesture_Swipe_Up.png"),
+			ButtonInputProperties("Swipe Down", "ControllerGraphics/Gestures/Gesture_Swipe_Bottom.png"),
+			ButtonInputProperties("Rotate", "ControllerGraphics/Gestures/Gesture_Double_Rotate.png"),
+			ButtonInputProperties("Circle", "ControllerGraphics/Gestures/Gesture_Full_Circle.png"),
+		};
+		mCurrent.resize(mInputProperties.size());
+		mLast.resize(mInputProperties.size());
+		mFrameEvents.reserve(GestureRecognizer::MaxPointers * 2);
+	}
+
+	auto GestureDevice::AddTemplate(std::string name, std::span<vec2 const> points, bool rotation_invariant, std::string glyph_uri) -> size_t
+	{
+		const auto index = Recognizer.AddTemplate(name, points, rotation_invariant);
+		if (index == InvalidIndex)
+			return InvalidIndex;
+
+		mInputProperties.push_back(ButtonInputProperties(name, std::move(glyph_uri)));
+		mCurrent.resize(mInputProperties.size());
+		mLast.resize(mInputProperties.size());
+		return FirstTemplateInput + index;
+	}
+
+	bool GestureDevice::IsAnyInputActive() const
+	{
+		return std::ranges::any_of(mCurrent, [](double value) { return value != 0; });
+	}
+
+	void GestureDevice::NewFrame()
+	{
+		std::ranges::copy(mCurrent, mLast.begin());
+		std::ranges::fill(mCurrent, 0.0);
+		mFrameEvents.clear();
+	}
+
+	void GestureDevice::CollectEvents()
+	{
+		for (auto const& event : Recognizer.Events())
+		{
+			const auto input = event.Type == GestureType::Template ? FirstTemplateInput + event.Template : size_t(event.Type);
+			if (input < mCurrent.size())
+				mCurrent[input] = 1.0;
+			mFrameEvents.push_back(event);
+		}
+		Recognizer.ClearEvents();
+	}
+}
@@ -0,0 +1,261 @@
+#include "GlyphAtlas.h"
+#include "InputDevice.h"
+
+#include <algorithm>
+
+namespace libgameinput
+{
+	auto PrimaryGlyphURI(std::string_view glyph_uris) -> std::string_view
+	{
+		return glyph_uris.substr(0, glyph_uris.find('\n'));
+	}
+
+	static auto GlyphGroup(std::string_view glyph_uri) -> std::string_view
+	{
+		const auto last_slash = glyph_uri.find_last_of('/');
+		return last_slash == std::string_view::npos ? std::string_view{} : glyph_uri.substr(0, last_slash);
+	}
+
+	auto GlyphAtlas::Find(std::string_view glyph_uri) const -> GlyphAtlasRect const*
+	{
+		if (auto it = mRects.find(glyph_uri); it != mRects.end())
+			return &it->second;
+		return nullptr;
+	}
+
+	auto GlyphAtlas::RectFor(InputProperties const& input) const -> GlyphAtlasRect const*
+	{
+		return Find(PrimaryGlyphURI(input.GlyphURIs));
+	}
+
+	auto GlyphAtlas::RectFor(IInputDevice const& device, size_t input) const -> GlyphAtlasRect const*
+	{
+		const auto inputs = device.ValidInputs();
+		if (input >= inputs.size())
+			return nullptr;
+		for (auto const& table : mBoundTables)
+		{
+			/// Tables that grew since they were bound (e.g. touch devices adding virtual controls) are not matched
+			if (table.Inputs.data() == inputs.data() && table.Inputs.size() == inputs.size())
+				return table.Rects[input];
+		}
+		return RectFor(inputs[input]);
+	}
+
+	void GlyphAtlas::BindDevices(std::span<std::unique_ptr<IInputDevice> const> devices)
+	{
+		mBoundTables.clear();
+		for (auto const& device : devices)
+		{
+			if (!device)
+				continue;
+			const auto inputs = device->ValidInputs();
+			if (inputs.empty() || std::ranges::any_of(mBoundTables, [&](BoundTable const& table) { return table.Inputs.data() == inputs.data() && table.Inputs.size() == inputs.size(); }))
+				continue;
+
+			auto& table = mBoundTables.emplace_back(BoundTable{ inputs });
+			table.Rects.reserve(inputs.size());
+			for (auto const& props : inputs)
+				table.Rects.push_back(RectFor(props));
+		}
+	}
+
+	void GlyphAtlasBuilder::Add(std::string_view glyph_uri, uint16_t width, uint16_t height)
+	{
+		mGlyphs.push_back({ std::string{ glyph_uri }, width, height });
+	}
+
+	auto GlyphAtlasBuilder::Build(uint16_t page_size, uint16_t padding, std::function<void(std::string_view, GlyphAtlasRect const&)> blit) const -> GlyphAtlas
+	{
+		GlyphAtlas result;
+
+		/// Shelf packing; sorting by group, then by descending height, keeps shelves tight
+		std::vector<Glyph const*> sorted;
+		sorted.reserve(mGlyphs.size());
+		for (auto& glyph : mGlyphs)
+			sorted.push_back(&glyph);
+		std::ranges::stable_sort(sorted, [](Glyph const* a, Glyph const* b) {
+			const auto group_a = GlyphGroup(a->URI);
+			const auto group_b = GlyphGroup(b->URI);
+			if (group_a != group_b)
+				return group_a < group_b;
+			return a->Height > b->Height;
+		});
+
+		std::string_view current_group;
+		size_t current_page = InvalidIndex;
+		uint32_t shelf_x = 0, shelf_y = 0, shelf_height = 0;
+
+		const auto new_page = [&](std::string_view group, uint16_t width, uint16_t height) {
+			current_page = result.mPages.size();
+			result.mPages.push_back({ std::string{ group }, width, height });
+			shelf_x = shelf_y = shelf_height = 0;
+		};
+
+		for (auto glyph : sorted)
+		{
+			if (result.mRects.contains(glyph->URI))
+				continue;
+
+			const auto group = GlyphGroup(glyph->URI);
+			const uint32_t width = glyph->Width + padding;
+			const uint32_t height = glyph->Height + padding;
+
+			GlyphAtlasRect rect{ 0, 0, 0, glyph->Width, glyph->Height };
+			if (width > page_size || height > page_size)
+			{
+				/// Oversized glyphs get their own page, and don't disturb the current one
+				rect.Page = (uint16_t)result.mPages.size();
+				result.mPages.push_back({ std::string{ group }, glyph->Width, glyph->Height });
+			}
+			else
+			{
+				if (current_page == InvalidIndex || group != current_group)
+				{
+					new_page(group, page_size, page_size);
+					current_group = group;
+				}
+
+				if (shelf_x + width > page_size)
+				{
+					shelf_y += shelf_height;
+					shelf_x = shelf_height = 0;
+				}
+				if (shelf_y + height > page_size)
+					new_page(group, page_size, page_size);
+
+				rect.Page = (uint16_t)current_page;
+				rect.X = (uint16_t)shelf_x;
+				rect.Y = (uint16_t)shelf_y;
+				shelf_x += width;
+				shelf_height = std::max(shelf_height, height);
+			}
+
+			result.mRects.emplace(glyph->URI, rect);
+			if (blit)
+				blit(glyph->URI, rect);
+		}
+
+		return result;
+	}
+
+	/// Binary index format, little endian:
+	///		"LGIA", u32 version, u32 page count, pages: { u16 group length, group, u16 width, u16 height },
+	///		u32 glyph count, glyphs: { u16 uri length, uri, u16 page, u16 x, u16 y, u16 width, u16 height }
+	static constexpr uint32_t GlyphAtlasVersion = 1;
+
+	namespace
+	{
+		struct BinaryWriter
+		{
+			std::vector<uint8_t> Data;
+
+			void Write(uint16_t val) { Data.push_back(uint8_t(val)); Data.push_back(uint8_t(val >> 8)); }
+			void Write(uint32_t val) { Write(uint16_t(val)); Write(uint16_t(val >> 16)); }
+			void Write(std::string_view str) { Write(uint16_t(str.size())); Data.insert(Data.end(), str.begin(), str.end()); }
+		};
+
+		struct BinaryReader
+		{
+			std::span<uint8_t const> Data;
+			bool Failed = false;
+
+			bool Read(uint16_t& val)
+			{
+				if (Data.size() < 2) return !(Failed = true);
+				val = uint16_t(Data[0] | (Data[1] << 8));
+				Data = Data.subspan(2);
+				return true;
+			}
+			bool Read(uint32_t& val)
+			{
+				uint16_t lo = 0, hi = 0;
+				if (!Read(lo) || !Read(hi)) return false;
+				val = uint32_t(lo) | (uint32_t(hi) << 16);
+				return true;
+			}
+			bool Read(std::string& str)
+			{
+				uint16_t size = 0;
+				if (!Read(size) || Data.size() < size) return !(Failed = true);
+				str.assign((char const*)Data.data(), size);
+				Data = Data.subspan(size);
+				return true;
+			}
+		};
+	}
+
+	auto GlyphAtlas::Serialize() const -> std::vector<uint8_t>
+	{
+		BinaryWriter writer{ { 'L', 'G', 'I', 'A' } };
+		writer.Write(GlyphAtlasVersion);
+		writer.Write(uint32_t(mPages.size()));
+		for (auto& page : mPages)
+		{
+			writer.Write(page.Group);
+			writer.Write(page.Width);
+			writer.Write(page.Height);
+		}
+		/// Sorted by URI, so that the same atlas always serializes to the same bytes
+		std::vector<std::pair<std::string const, GlyphAtlasRect> const*> rects;
+		rects.reserve(mRects.size());
+		for (auto& entry : mRects)
+			rects.push_back(&entry);
+		std::ranges::sort(rects, {}, [](auto const* entry) -> std::string_view { return entry->first; });
+
+		writer.Write(uint32_t(rects.size()));
+		for (auto const* entry : rects)
+		{
+			auto const& [uri, rect] = *entry;
+			writer.Write(uri);
+			writer.Write(rect.Page);
+			writer.Write(rect.X);
+			writer.Write(rect.Y);
+			writer.Write(rect.Width);
+			writer.Write(rect.Height);
+		}
+		return std::move(writer.Data);
+	}
+
+	auto GlyphAtlas::Deserialize(std::span<uint8_t const> data) -> std::optional<GlyphAtlas>
+	{
+		if (data.size() < 4 || data[0] != 'L' || data[1] != 'G' || data[2] != 'I' || data[3] != 'A')
+			return std::nullopt;
+
+		BinaryReader reader{ data.subspan(4) };
+		uint32_t version = 0, page_count = 0, glyph_count = 0;
+		if (!reader.Read(version) || version != GlyphAtlasVersion || !reader.Read(page_count))
+			return std::nullopt;
+
+		/// Every page takes at least 6 bytes, and every glyph at least 12, so bogus counts can be rejected before allocating
+		if (page_count > reader.Data.size() / 6)
+			return std::nullopt;
+
+		GlyphAtlas result;
+		result.mPages.resize(page_count);
+		for (auto& page : result.mPages)
+		{
+			if (!reader.Read(page.Group) || !reader.Read(page.Width) || !reader.Read(page.Height))
+				return std::nullopt;
+		}
+
+		if (!reader.Read(glyph_count) || glyph_count > reader.Data.size() / 12)
+			return std::nullopt;
+		result.mRects.reserve(glyph_count);
+		for (uint32_t i = 0; i < glyph_count && !reader.Failed; ++i)
+		{
+			std::string uri;
+			GlyphAtlasRect rect;
+			if (reader.Read(uri) && reader.Read(rect.Page) && reader.Read(rect.X) && reader.Read(rect.Y) && reader.Read(rect.Width) && reader.Read(rect.Height))
+			{
+				if (rect.Page >= page_count)
+					return std::nullopt;
+				result.mRects.emplace(std::move(uri), rect);
+			}
+		}
+
+		if (reader.Failed)
+			return std::nullopt;
+		return result;
+	}
+}
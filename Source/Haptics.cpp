@@ -0,0 +1,328 @@
+#include "Haptics.h"
+#include "InputDevice.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace libgameinput
+{
+	auto HapticEffectDescription::ADSR(Seconds attack, Seconds decay, double sustain_level, Seconds sustain, Seconds release) -> HapticEffectDescription
+	{
+		HapticEffectDescription result;
+		result.Envelope = {
+			{ Seconds{ 0 }, 0.0 },
+			{ attack, 1.0 },
+			{ attack + decay, sustain_level },
+			{ attack + decay + sustain, sustain_level },
+			{ attack + decay + sustain + release, 0.0 },
+		};
+		return result;
+	}
+
+	void HapticsEngine::SampleRing::Push(std::span<int8_t const> samples)
+	{
+		auto write = Write.load(std::memory_order_relaxed);
+		for (auto sample : samples.first(std::min(samples.size(), Free())))
+			Samples[write++ & (RingSize - 1)] = sample;
+		Write.store(write, std::memory_order_release);
+	}
+
+	void HapticsEngine::SampleRing::Pull(std::span<uint8_t> into)
+	{
+		auto read = Read.load(std::memory_order_relaxed);
+		const auto available = size_t(Write.load(std::memory_order_acquire) - read);
+		const auto count = std::min(available, into.size());
+		for (size_t i = 0; i < count; ++i)
+			into[i] = uint8_t(Samples[read++ & (RingSize - 1)]);
+		/// Underruns play silence
+		std::fill(into.begin() + count, into.end(), uint8_t{ 0 });
+		Read.store(read, std::memory_order_release);
+	}
+
+	HapticsEngine::HapticsEngine(OutputScheduler& fallback_outputs, double sample_rate)
+		: mFallbackOutputs(fallback_outputs)
+		, mSampleRate(sample_rate > 0 ? sample_rate : 3000.0)
+	{
+	}
+
+	HapticsEngine::~HapticsEngine()
+	{
+		for (auto& stream : mStreams)
+		{
+			if (stream.Device && stream.Pulled)
+				stream.Device->SetOutputCallback(stream.Output, {});
+		}
+	}
+
+	auto HapticsEngine::LoadEffect(HapticEffectDescription const& description) -> size_t
+	{
+		auto const& envelope = description.Envelope;
+		const auto duration = envelope.empty() ? 0.0 : envelope.back().Time.count();
+		const auto length = std::max(size_t(1), size_t(std::ceil(duration * mSampleRate)));
+
+		Effect effect{ mEnvelopePool.size(), length, description.Motors, description.Loop };
+		mEnvelopePool.resize(mEnvelopePool.size() + length);
+		mWaveformPool.resize(mWaveformPool.size() + length);
+
+		size_t point = 0;
+		for (size_t i = 0; i < length; ++i)
+		{
+			const auto time = double(i) / mSampleRate;
+			while (point + 1 < envelope.size() && envelope[point + 1].Time.count() <= time)
+				++point;
+
+			double amplitude = 0;
+			if (point + 1 < envelope.size())
+			{
+				auto const& from = envelope[point];
+				auto const& to = envelope[point + 1];
+				const auto span = (to.Time - from.Time).count();
+				const auto t = span > 0 ? std::clamp((time - from.Time.count()) / span, 0.0, 1.0) : 1.0;
+				amplitude = from.Amplitude + (to.Amplitude - from.Amplitude) * t;
+			}
+			else if (!envelope.empty())
+				amplitude = envelope.back().Amplitude;
+			amplitude = std::clamp(amplitude, 0.0, 1.0);
+
+			const auto carrier = description.Frequency > 0 ? std::sin(2.0 * std::numbers::pi * description.Frequency * time) : 1.0;
+			mEnvelopePool[effect.Offset + i] = float(amplitude);
+			mWaveformPool[effect.Offset + i] = float(amplitude * carrier);
+		}
+
+		mEffects.push_back(effect);
+		return mEffects.size() - 1;
+	}
+
+	auto HapticsEngine::EffectDuration(size_t effect) const -> Seconds
+	{
+		return effect < mEffects.size() ? Seconds{ double(mEffects[effect].Length) / mSampleRate } : Seconds{ 0 };
+	}
+
+	auto HapticsEngine::StreamOf(IInputDevice& device) -> DeviceStream*
+	{
+		DeviceStream* free_slot = nullptr;
+		for (auto& stream : mStreams)
+		{
+			if (stream.Device == &device)
+				return &stream;
+			if (!stream.Device && !free_slot)
+				free_slot = &stream;
+		}
+		if (!free_slot)
+			return nullptr;
+
+		/// Waveform outputs are preferred, as they can play everything the motors can
+		const auto outputs = device.ValidOutputs();
+		size_t waveform = InvalidIndex, motors = InvalidIndex;
+		for (size_t index = 0; index < outputs.size(); ++index)
+		{
+			if (outputs[index].Type != InputDeviceOutputType::Vibration)
+				continue;
+			auto& found = outputs[index].Flags.contains(OutputFlags::Waveform) ? waveform : motors;
+			if (found == InvalidIndex)
+				found = index;
+		}
+		if (waveform == InvalidIndex && motors == InvalidIndex)
+			return nullptr;
+
+		auto& stream = *free_slot;
+		stream.Device = &device;
+		stream.Waveform = waveform != InvalidIndex;
+		stream.Output = stream.Waveform ? waveform : motors;
+		const auto period = outputs[stream.Output].UpdateFrequency;
+		stream.SampleRate = period > Seconds{ 0 } ? 1.0 / period.count() : mSampleRate;
+		stream.PendingSamples = 0;
+		stream.Voices = 0;
+		stream.Ring.Read.store(0, std::memory_order_relaxed);
+		stream.Ring.Write.store(0, std::memory_order_relaxed);
+		stream.Pulled = stream.Waveform && device.SetOutputCallback(stream.Output, [ring = &stream.Ring](std::span<uint8_t> into) {
+			ring->Pull(into);
+		});
+		return &stream;
+	}
+
+	auto HapticsEngine::Play(IInputDevice& device, size_t effect, double gain) -> HapticVoice
+	{
+		if (effect >= mEffects.size())
+			return NoHapticVoice;
+
+		const auto voice = std::ranges::find(mVoices, InvalidIndex, &Voice::Effect);
+		if (voice == mVoices.end())
+			return NoHapticVoice;
+		const auto stream = StreamOf(device);
+		if (!stream)
+			return NoHapticVoice;
+
+		voice->Generation = std::max(voice->Generation + 1, 1u);
+		voice->Stream = uint32_t(stream - mStreams.data());
+		voice->Effect = effect;
+		voice->Position = 0;
+		voice->Gain = float(gain);
+		++stream->Voices;
+		return (HapticVoice(voice->Generation) << 32) | HapticVoice(voice - mVoices.begin());
+	}
+
+	auto HapticsEngine::VoiceOf(HapticVoice voice) -> Voice*
+	{
+		return const_cast<Voice*>(std::as_const(*this).VoiceOf(voice));
+	}
+
+	auto HapticsEngine::VoiceOf(HapticVoice voice) const -> Voice const*
+	{
+		const auto index = size_t(voice & 0xFFFFFFFF);
+		if (index >= mVoices.size())
+			return nullptr;
+		auto const& state = mVoices[index];
+		return state.Effect != InvalidIndex && state.Generation == uint32_t(voice >> 32) ? &state : nullptr;
+	}
+
+	void HapticsEngine::FreeVoice(Voice& voice)
+	{
+		voice.Effect = InvalidIndex;
+		--mStreams[voice.Stream].Voices;
+	}
+
+	void HapticsEngine::Stop(HapticVoice voice)
+	{
+		if (const auto state = VoiceOf(voice))
+			FreeVoice(*state);
+	}
+
+	void HapticsEngine::SetGain(HapticVoice voice, double gain)
+	{
+		if (const auto state = VoiceOf(voice))
+			state->Gain = float(gain);
+	}
+
+	bool HapticsEngine::IsPlaying(HapticVoice voice) const
+	{
+		return VoiceOf(voice) != nullptr;
+	}
+
+	void HapticsEngine::StopAll(IInputDevice const* device)
+	{
+		for (auto& voice : mVoices)
+		{
+			if (voice.Effect != InvalidIndex && (!device || mStreams[voice.Stream].Device == device))
+				FreeVoice(voice);
+		}
+	}
+
+	void HapticsEngine::RemoveDevice(IInputDevice const* device)
+	{
+		if (!device)
+			return;
+		StopAll(device);
+		for (auto& stream : mStreams)
+		{
+			if (stream.Device != device)
+				continue;
+			if (stream.Pulled)
+				stream.Device->SetOutputCallback(stream.Output, {});
+			stream.Device = nullptr;
+		}
+		mFallbackOutputs.RemoveDevice(device);
+	}
+
+	void HapticsEngine::Update(TimePoint now)
+	{
+		const auto elapsed = mLastUpdate == TimePoint{} ? 0.0 : std::max(Seconds{ now - mLastUpdate }.count(), 0.0);
+		mLastUpdate = now;
+
+		for (uint32_t index = 0; index < mStreams.size(); ++index)
+		{
+			auto& stream = mStreams[index];
+			if (!stream.Device)
+				continue;
+
+			if (stream.Waveform)
+				MixWaveform(stream, index, elapsed);
+			else
+				MixAmplitude(stream, index);
+
+			/// Idle devices give their slot back; the scheduler resets their motors once nothing is posted to them
+			if (stream.Voices == 0)
+			{
+				if (stream.Pulled)
+					stream.Device->SetOutputCallback(stream.Output, {});
+				stream.Device = nullptr;
+			}
+		}
+
+		const auto advance = elapsed * mSampleRate;
+		for (auto& voice : mVoices)
+		{
+			if (voice.Effect == InvalidIndex)
+				continue;
+			auto const& effect = mEffects[voice.Effect];
+			voice.Position += advance;
+			if (voice.Position >= double(effect.Length))
+			{
+				if (effect.Loop)
+					voice.Position = std::fmod(voice.Position, double(effect.Length));
+				else
+					FreeVoice(voice);
+			}
+		}
+	}
+
+	void HapticsEngine::MixWaveform(DeviceStream& stream, uint32_t stream_index, double elapsed)
+	{
+		stream.PendingSamples += elapsed * stream.SampleRate;
+		auto count = std::min(size_t(stream.PendingSamples), MaxChunk);
+		stream.PendingSamples = std::min(stream.PendingSamples - double(count), 1.0);
+		if (stream.Pulled)
+			count = std::min(count, stream.Ring.Free());
+		if (count == 0)
+			return;
+
+		const auto mix = std::span{ mMix }.first(count);
+		std::ranges::fill(mix, 0.0f);
+		const auto step = mSampleRate / stream.SampleRate;
+		for (auto const& voice : mVoices)
+		{
+			if (voice.Effect == InvalidIndex || voice.Stream != stream_index)
+				continue;
+			auto const& effect = mEffects[voice.Effect];
+			const auto table = std::span{ mWaveformPool }.subspan(effect.Offset, effect.Length);
+			auto position = voice.Position;
+			for (auto& sample : mix)
+			{
+				if (position >= double(table.size()))
+				{
+					if (!effect.Loop)
+						break;
+					position = std::fmod(position, double(table.size()));
+				}
+				sample += table[size_t(position)] * voice.Gain;
+				position += step;
+			}
+		}
+
+		const auto chunk = std::span{ mChunk }.first(count);
+		for (size_t i = 0; i < count; ++i)
+			chunk[i] = int8_t(std::lround(std::clamp(mix[i], -1.0f, 1.0f) * 127.0f));
+
+		if (stream.Pulled)
+			stream.Ring.Push(chunk);
+		else
+			stream.Device->SendOutputData(stream.Output, { reinterpret_cast<uint8_t const*>(chunk.data()), chunk.size() });
+	}
+
+	void HapticsEngine::MixAmplitude(DeviceStream& stream, uint32_t stream_index)
+	{
+		vec2 motors{};
+		for (auto const& voice : mVoices)
+		{
+			if (voice.Effect == InvalidIndex || voice.Stream != stream_index)
+				continue;
+			auto const& effect = mEffects[voice.Effect];
+			const auto amplitude = double(mEnvelopePool[effect.Offset + std::min(size_t(voice.Position), effect.Length - 1)]) * voice.Gain;
+			motors += effect.Motors * amplitude;
+		}
+		if (stream.Voices > 0)
+			mFallbackOutputs.Post(*stream.Device, stream.Output, { vec3{ motors, 0.0 }, FallbackPriority, FallbackBlend });
+	}
+}
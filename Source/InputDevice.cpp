@@ -12,201 +12,159 @@ namespace libgameinput
 
 	std::string_view IInputDevice::Name() const { return StringPropertyValue(StringProperty::Name); }
 
-	auto IInputDevice::InputPropertiesOf(size_t index) -> InputProperties const*
+	auto IInputDevice::InputPropertiesOf(size_t index) const -> InputProperties const*
 	{
 		const auto props = ValidInputs();
 		return index < props.size() ? &props[index] : nullptr;
 	}
 
-	bool IKeyboardDevice::CanTriggerNavigation(UINavigationInput input) const
+	bool IInputDevice::CanTriggerNavigation(UINavigationInput input) const
 	{
-		switch (input)
-		{
-		case UINavigationInput::Accept:
-		case UINavigationInput::Cancel:
-		case UINavigationInput::Left:
-		case UINavigationInput::Right:
-		case UINavigationInput::Up:
-		case UINavigationInput::Down:
-		case UINavigationInput::Home:
-		case UINavigationInput::End:
-		case UINavigationInput::PageUp:
-		case UINavigationInput::PageDown:
-			return true;
-		case UINavigationInput::Back:
-		case UINavigationInput::Forward:
-		case UINavigationInput::Menu:
-		case UINavigationInput::View:
-		case UINavigationInput::PageLeft:
-		case UINavigationInput::PageRight:
-		case UINavigationInput::ScrollUp:
-		case UINavigationInput::ScrollDown:
-		case UINavigationInput::ScrollLeft:
-		case UINavigationInput::ScrollRight:
-			return false;
-		}
-		return false;
+		return std::ranges::any_of(NavigationBindings(), [input](NavigationBinding const& binding) { return binding.Navigation == input && binding.Input != InvalidIndex; });
 	}
 
-	bool IKeyboardDevice::IsNavigationPressed(UINavigationInput input) const
+	/// These read the raw device values, without remapping or analog processing; `IInputSystem::IsNavigationPressed` has both
+	static bool IsNavigationBindingPressed(IInputDevice const& device, UINavigationInput input, bool last_frame)
 	{
-		switch (input)
+		for (auto const& binding : device.NavigationBindings())
 		{
-		case UINavigationInput::Accept: return IsInputPressed((size_t)KeyboardButton::Enter);
-		case UINavigationInput::Cancel: return IsInputPressed((size_t)KeyboardButton::Escape);
-		case UINavigationInput::Left: return IsInputPressed((size_t)KeyboardButton::Left);
-		case UINavigationInput::Right: return IsInputPressed((size_t)KeyboardButton::Right);
-		case UINavigationInput::Up: return IsInputPressed((size_t)KeyboardButton::Up);
-		case UINavigationInput::Down: return IsInputPressed((size_t)KeyboardButton::Down);
-		case UINavigationInput::Home: return IsInputPressed((size_t)KeyboardButton::Home);
-		case UINavigationInput::End: return IsInputPressed((size_t)KeyboardButton::End);
-		case UINavigationInput::PageUp: return IsInputPressed((size_t)KeyboardButton::PageUp);
-		case UINavigationInput::PageDown: return IsInputPressed((size_t)KeyboardButton::PageDown);
-		case UINavigationInput::Back:
-		case UINavigationInput::Forward:
-		case UINavigationInput::Menu:
-		case UINavigationInput::View:
-		case UINavigationInput::PageLeft:
-		case UINavigationInput::PageRight:
-		case UINavigationInput::ScrollUp:
-		case UINavigationInput::ScrollDown:
-		case UINavigationInput::ScrollLeft:
-		case UINavigationInput::ScrollRight:
-			return false;
+			if (binding.Navigation != input || binding.Input == InvalidIndex)
+				continue;
+			const auto props = device.InputPropertiesOf(binding.Input);
+			const auto threshold = std::isnan(binding.PressThreshold) ? (props ? props->PressedThreshold : 0.5) : binding.PressThreshold;
+			const auto value = last_frame ? device.InputValueLastFrame(binding.Input) : device.InputValue(binding.Input);
+			if (binding.Direction * value >= threshold)
+				return true;
 		}
 		return false;
 	}
 
-	bool IKeyboardDevice::WasNavigationPressedLastFrame(UINavigationInput input) const
+	bool IInputDevice::IsNavigationPressed(UINavigationInput input) const
 	{
-		switch (input)
-		{
-		case UINavigationInput::Accept: return WasInputPressedLastFrame((size_t)KeyboardButton::Enter);
-		case UINavigationInput::Cancel: return WasInputPressedLastFrame((size_t)KeyboardButton::Escape);
-		case UINavigationInput::Left: return WasInputPressedLastFrame((size_t)KeyboardButton::Left);
-		case UINavigationInput::Right: return WasInputPressedLastFrame((size_t)KeyboardButton::Right);
-		case UINavigationInput::Up: return WasInputPressedLastFrame((size_t)KeyboardButton::Up);
-		case UINavigationInput::Down: return WasInputPressedLastFrame((size_t)KeyboardButton::Down);
-		case UINavigationInput::Home: return WasInputPressedLastFrame((size_t)KeyboardButton::Home);
-		case UINavigationInput::End: return WasInputPressedLastFrame((size_t)KeyboardButton::End);
-		case UINavigationInput::PageUp: return WasInputPressedLastFrame((size_t)KeyboardButton::PageUp);
-		case UINavigationInput::PageDown: return WasInputPressedLastFrame((size_t)KeyboardButton::PageDown);
-		case UINavigationInput::Back:
-		case UINavigationInput::Forward:
-		case UINavigationInput::Menu:
-		case UINavigationInput::View:
-		case UINavigationInput::PageLeft:
-		case UINavigationInput::PageRight:
-		case UINavigationInput::ScrollUp:
-		case UINavigationInput::ScrollDown:
-		case UINavigationInput::ScrollLeft:
-		case UINavigationInput::ScrollRight:
-			return false;
-		}
-		return false;
+		return IsNavigationBindingPressed(*this, input, false);
 	}
 
-	bool IMouseDevice::CanTriggerNavigation(UINavigationInput input) const
+	bool IInputDevice::WasNavigationPressedLastFrame(UINavigationInput input) const
 	{
-		switch (input)
+		return IsNavigationBindingPressed(*this, input, true);
+	}
+
+	auto IKeyboardDevice::NavigationBindings() const -> std::span<NavigationBinding const>
+	{
+		static constexpr NavigationBinding bindings[] = {
+			{ UINavigationInput::Accept, (size_t)KeyboardButton::Enter },
+			{ UINavigationInput::Cancel, (size_t)KeyboardButton::Escape },
+			{ UINavigationInput::Left, (size_t)KeyboardButton::Left },
+			{ UINavigationInput::Right, (size_t)KeyboardButton::Right },
+			{ UINavigationInput::Up, (size_t)KeyboardButton::Up },
+			{ UINavigationInput::Down, (size_t)KeyboardButton::Down },
+			{ UINavigationInput::Home, (size_t)KeyboardButton::Home },
+			{ UINavigationInput::End, (size_t)KeyboardButton::End },
+			{ UINavigationInput::PageUp, (size_t)KeyboardButton::PageUp },
+			{ UINavigationInput::PageDown, (size_t)KeyboardButton::PageDown },
+		};
+		return bindings;
+	}
+
+	auto IMouseDevice::NavigationBindings() const -> std::span<NavigationBinding const>
+	{
+		if (mNavigationBindingCount == InvalidIndex)
 		{
-			/// SM_MOUSEHORIZONTALWHEELPRESENT
-			/// SM_MOUSEWHEELPRESENT
-			/// SM_CMOUSEBUTTONS
-		case UINavigationInput::Accept:
-		case UINavigationInput::Cancel:
-			return true;
-		case UINavigationInput::ScrollUp:
-		case UINavigationInput::ScrollDown:
-			return VerticalWheelInputID() != InvalidIndex;
-		case UINavigationInput::ScrollLeft:
-		case UINavigationInput::ScrollRight:
-			return HorizontalWheelInputID() != InvalidIndex;
-
-		case UINavigationInput::Left:
-		case UINavigationInput::Right:
-		case UINavigationInput::Up:
-		case UINavigationInput::Down:
-		case UINavigationInput::Home:
-		case UINavigationInput::End:
-		case UINavigationInput::Back:
-		case UINavigationInput::Forward:
-		case UINavigationInput::Menu:
-		case UINavigationInput::View:
-		case UINavigationInput::PageLeft:
-		case UINavigationInput::PageRight:
-		case UINavigationInput::PageUp:
-		case UINavigationInput::PageDown:
-			return false;
+			/// Wheels trigger on any movement
+			constexpr auto any = std::numeric_limits<float>::min();
+			size_t count = 0;
+			mNavigationBindings[count++] = { UINavigationInput::Accept, (size_t)MouseButton::Left };
+			mNavigationBindings[count++] = { UINavigationInput::Cancel, (size_t)MouseButton::Right };
+			if (const auto wheel = VerticalWheelInputID(); wheel != InvalidIndex)
+			{
+				mNavigationBindings[count++] = { UINavigationInput::ScrollUp, wheel, -1, any };
+				mNavigationBindings[count++] = { UINavigationInput::ScrollDown, wheel, 1, any };
+			}
+			if (const auto wheel = HorizontalWheelInputID(); wheel != InvalidIndex)
+			{
+				mNavigationBindings[count++] = { UINavigationInput::ScrollLeft, wheel, -1, any };
+				mNavigationBindings[count++] = { UINavigationInput::ScrollRight, wheel, 1, any };
+			}
+			mNavigationBindingCount = count;
 		}
-		return false;
+		return std::span{ mNavigationBindings }.first(mNavigationBindingCount);
 	}
 
-	bool IMouseDevice::IsNavigationPressed(UINavigationInput input) const
+	int IMouseDevice::ClickCount(MouseButton button) const
 	{
-		switch (input)
+		if (size_t(button) >= ButtonSlots)
+			return 0;
+		auto const& state = mClicks[size_t(button)];
+		return state.Held ? state.Count : state.PressedThisFrame;
+	}
+
+	int IMouseDevice::ClickCountLastFrame(MouseButton button) const
+	{
+		return size_t(button) < ButtonSlots ? mClicks[size_t(button)].LastFrame : 0;
+	}
+
+	void IMouseDevice::UseSystemMultiClickSettings(ISystemDevice const& system)
+	{
+		if (system.IsSystemConfigValid(ISystemDevice::SystemConfig::DoubleClickTime))
+			mMultiClickSettings.MaxInterval = Seconds{ system.SystemConfigValue(ISystemDevice::SystemConfig::DoubleClickTime).x };
+		if (system.IsSystemConfigValid(ISystemDevice::SystemConfig::DoubleClickDistance))
+			mMultiClickSettings.MaxDistance = vec2{ system.SystemConfigValue(ISystemDevice::SystemConfig::DoubleClickDistance) };
+	}
+
+	void IMouseDevice::NewFrame()
+	{
+		for (size_t i = 0; i < ButtonSlots; ++i)
 		{
-		case UINavigationInput::Accept: return IsInputPressed((size_t)MouseButton::Left);
-		case UINavigationInput::Cancel: return IsInputPressed((size_t)MouseButton::Right);
-		case UINavigationInput::ScrollUp: return InputValue(VerticalWheelInputID()) < 0;
-		case UINavigationInput::ScrollDown: return InputValue(VerticalWheelInputID()) > 0;
-		case UINavigationInput::ScrollLeft: return InputValue(HorizontalWheelInputID()) < 0;
-		case UINavigationInput::ScrollRight: return InputValue(HorizontalWheelInputID()) > 0;
-
-		case UINavigationInput::Left:
-		case UINavigationInput::Right:
-		case UINavigationInput::Up:
-		case UINavigationInput::Down:
-		case UINavigationInput::Home:
-		case UINavigationInput::End:
-		case UINavigationInput::Back:
-		case UINavigationInput::Forward:
-		case UINavigationInput::Menu:
-		case UINavigationInput::View:
-		case UINavigationInput::PageLeft:
-		case UINavigationInput::PageRight:
-		case UINavigationInput::PageUp:
-		case UINavigationInput::PageDown:
-			return false;
+			mClicks[i].LastFrame = ClickCount(MouseButton(i));
+			mClicks[i].PressedThisFrame = 0;
 		}
-		return false;
+		mClickEventCount = 0;
 	}
 
-	bool IMouseDevice::WasNavigationPressedLastFrame(UINavigationInput input) const
+	void IMouseDevice::RecordButtonPress(MouseButton button, vec2 position, TimePoint time)
 	{
-		switch (input)
+		if (size_t(button) >= ButtonSlots)
+			return;
+
+		auto& state = mClicks[size_t(button)];
+		const bool continues = state.Count > 0
+			&& time - state.LastPressTime <= mMultiClickSettings.MaxInterval
+			&& std::abs(position.x - state.FirstPressPosition.x) <= mMultiClickSettings.MaxDistance.x 
+			&& std::abs(position.y - state.FirstPressPosition.y) <= mMultiClickSettings.MaxDistance.y
+			&& (mMultiClickSettings.MaxCount <= 0 || state.Count < mMultiClickSettings.MaxCount);
+
+		if (continues)
+			++state.Count;
+		else
 		{
-		case UINavigationInput::Accept: return WasInputPressedLastFrame((size_t)MouseButton::Left);
-		case UINavigationInput::Cancel: return WasInputPressedLastFrame((size_t)MouseButton::Right);
-		case UINavigationInput::ScrollUp: return InputValueLastFrame(VerticalWheelInputID()) < 0;
-		case UINavigationInput::ScrollDown: return InputValueLastFrame(VerticalWheelInputID()) > 0;
-		case UINavigationInput::ScrollLeft: return InputValueLastFrame(HorizontalWheelInputID()) < 0;
-		case UINavigationInput::ScrollRight: return InputValueLastFrame(HorizontalWheelInputID()) > 0;
-
-		case UINavigationInput::Left:
-		case UINavigationInput::Right:
-		case UINavigationInput::Up:
-		case UINavigationInput::Down:
-		case UINavigationInput::Home:
-		case UINavigationInput::End:
-		case UINavigationInput::Back:
-		case UINavigationInput::Forward:
-		case UINavigationInput::Menu:
-		case UINavigationInput::View:
-		case UINavigationInput::PageLeft:
-		case UINavigationInput::PageRight:
-		case UINavigationInput::PageUp:
-		case UINavigationInput::PageDown:
-			return false;
+			state.Count = 1;
+			state.FirstPressPosition = position;
 		}
-		return false;
+		state.Held = true;
+		state.LastPressTime = time;
+		state.PressedThisFrame = std::max(state.PressedThisFrame, state.Count);
+
+		/// Pressing another button breaks the multi-clicks of the others
+		for (size_t i = 0; i < ButtonSlots; ++i)
+			if (i != size_t(button) && !mClicks[i].Held)
+				mClicks[i].Count = 0;
+
+		if (mClickEventCount < MaxClickEventsPerFrame)
+			mClickEvents[mClickEventCount++] = { button, state.Count, position, time };
+	}
+
+	void IMouseDevice::RecordButtonRelease(MouseButton button)
+	{
+		if (size_t(button) < ButtonSlots)
+			mClicks[size_t(button)].Held = false;
 	}
 
 	struct XboxButtonInputProperties : InputProperties
 	{
-		XboxButtonInputProperties(std::string_view name)
+		XboxButtonInputProperties(std::string_view name, std::string glyph_uri = {})
 		{
 			Name = name;
+			GlyphURIs = std::move(glyph_uri);
 			Flags.set(InputFlags::Digital);
 			DeadZoneMin = DeadZoneMax = MinValue = 0;
 			StepSize = 1;
@@ -215,9 +173,10 @@ namespace libgameinput
 
 	struct XboxStickAxisInputProperties : InputProperties
 	{
-		XboxStickAxisInputProperties(std::string_view name, double min = -1.0, double max = 1.0)
+		XboxStickAxisInputProperties(std::string_view name, std::string glyph_uri = {}, double min = -1.0, double max = 1.0)
 		{
 			Name = name;
+			GlyphURIs = std::move(glyph_uri);
 			Flags.unset(InputFlags::Digital);
 			Flags.set(InputFlags::ReturnsToNeutral);
 			Flags.set(InputFlags::HasDeadzone);
@@ -226,50 +185,32 @@ namespace libgameinput
 		}
 	};
 
-	std::optional<InputProperties> IXboxGamepadDevice::PropertiesOf(size_t input) const
-	{
-		static const std::map<XboxGamepadButton, XboxButtonInputProperties> button_properties = {
-			{ XboxGamepadButton::A, XboxButtonInputProperties("A") },
-			{ XboxGamepadButton::B, XboxButtonInputProperties("B") },
-			{ XboxGamepadButton::X, XboxButtonInputProperties("X") },
-			{ XboxGamepadButton::Y, XboxButtonInputProperties("Y") },
-			{ XboxGamepadButton::RightBumper, XboxButtonInputProperties("Right Bumper") },
-			{ XboxGamepadButton::LeftBumper, XboxButtonInputProperties("Left Bumper") },
-			{ XboxGamepadButton::RightStickButton, XboxButtonInputProperties("Right Stick") },
-			{ XboxGamepadButton::LeftStickButton, XboxButtonInputProperties("Left Stick") },
-			{ XboxGamepadButton::Back, XboxButtonInputProperties("Back") },
-			{ XboxGamepadButton::Start, XboxButtonInputProperties("Start") },
-			{ XboxGamepadButton::Right, XboxButtonInputProperties("Right") },
-			{ XboxGamepadButton::Left, XboxButtonInputProperties("Left") },
-			{ XboxGamepadButton::Down, XboxButtonInputProperties("Down") },
-			{ XboxGamepadButton::Up, XboxButtonInputProperties("Up") },
+	auto IXboxGamepadDevice::ValidInputs() const -> std::span<InputProperties const>
+	{
+		static const std::array<InputProperties, DefaultButtonCount + DefaultAxisCount> input_properties = {
+			XboxButtonInputProperties("A", "ControllerGraphics/Xbox One/XboxOne_A.png"),
+			XboxButtonInputProperties("B", "ControllerGraphics/Xbox One/XboxOne_B.png"),
+			XboxButtonInputProperties("X", "ControllerGraphics/Xbox One/XboxOne_X.png"),
+			XboxButtonInputProperties("Y", "ControllerGraphics/Xbox One/XboxOne_Y.png"),
+			XboxButtonInputProperties("Right Bumper", "ControllerGraphics/Xbox One/XboxOne_RB.png"),
+			XboxButtonInputProperties("Left Bumper", "ControllerGraphics/Xbox One/XboxOne_LB.png"),
+			XboxButtonInputProperties("Right Stick", "ControllerGraphics/Xbox One/XboxOne_Right_Stick.png"),
+			XboxButtonInputProperties("Left Stick", "ControllerGraphics/Xbox One/XboxOne_Left_Stick.png"),
+			XboxButtonInputProperties("Back", "ControllerGraphics/Xbox One/XboxOne_Windows.png"),
+			XboxButtonInputProperties("Start", "ControllerGraphics/Xbox One/XboxOne_Menu.png"),
+			XboxButtonInputProperties("Right", "ControllerGraphics/Xbox One/XboxOne_Dpad_Right.png"),
+			XboxButtonInputProperties("Left", "ControllerGraphics/Xbox One/XboxOne_Dpad_Left.png"),
+			XboxButtonInputProperties("Down", "ControllerGraphics/Xbox One/XboxOne_Dpad_Down.png"),
+			XboxButtonInputProperties("Up", "ControllerGraphics/Xbox One/XboxOne_Dpad_Up.png"),
+
+			XboxStickAxisInputProperties("Left Stick X Axis", "ControllerGraphics/Xbox One/XboxOne_Left_Stick.png"),
+			XboxStickAxisInputProperties("Left Stick Y Axis", "ControllerGraphics/Xbox One/XboxOne_Left_Stick.png"),
+			XboxStickAxisInputProperties("Right Stick X Axis", "ControllerGraphics/Xbox One/XboxOne_Right_Stick.png"),
+			XboxStickAxisInputProperties("Right Stick Y Axis", "ControllerGraphics/Xbox One/XboxOne_Right_Stick.png"),
+			XboxStickAxisInputProperties("Left Trigger", "ControllerGraphics/Xbox One/XboxOne_LT.png"),
+			XboxStickAxisInputProperties("Right Trigger", "ControllerGraphics/Xbox One/XboxOne_RT.png"),
 		};
-
-		if (!IsInputValid(input)) return {};
-		
-		if (input < DefaultButtonCount)
-		{
-			const auto input_button = (XboxGamepadButton)input;
-			if (auto it = button_properties.find(input_button); it != button_properties.end())
-				return it->second;
-		}
-		else
-		{
-			static const std::array<XboxStickAxisInputProperties, 6> axis_properties = {
-				XboxStickAxisInputProperties("Left Stick X Axis"),
-				XboxStickAxisInputProperties("Left Stick Y Axis"),
-				XboxStickAxisInputProperties("Right Stick X Axis"),
-				XboxStickAxisInputProperties("Right Stick Y Axis"),
-				XboxStickAxisInputProperties("Left Trigger"),
-				XboxStickAxisInputProperties("Right Trigger"),
-			};
-
-			const auto axis = input - DefaultButtonCount;
-			if (axis < 6)
-				return axis_properties[axis];
-		}
-		
-		return {};
+		return input_properties;
 	}
 
 	uint8_t IXboxGamepadDevice::StickCount() const
@@ -282,100 +223,54 @@ namespace libgameinput
 		return 2;
 	}
 
+	auto IXboxGamepadDevice::StickAxisInputs(uint8_t stick_num) -> std::array<size_t, 3>
+	{
+		switch (stick_num)
+		{
+		case 0: return { (size_t)Axes::LeftStick_XAxis, (size_t)Axes::LeftStick_YAxis, InvalidIndex };
+		case 1: return { (size_t)Axes::RightStick_XAxis, (size_t)Axes::RightStick_YAxis, InvalidIndex };
+		}
+		return { InvalidIndex, InvalidIndex, InvalidIndex };
+	}
+
 	uint8_t IXboxGamepadDevice::ButtonCount() const
 	{
 		return DefaultButtonCount;
 	}
 
-	bool IXboxGamepadDevice::CanTriggerNavigation(UINavigationInput input) const
+	vec2 IGamepadDevice::ProcessedStickValue(uint8_t stick_num) const
 	{
-		switch (input)
-		{
-		case UINavigationInput::Accept:
-		case UINavigationInput::Cancel:
-		case UINavigationInput::Menu:
-		case UINavigationInput::View:
-		case UINavigationInput::Left:
-		case UINavigationInput::Right:
-		case UINavigationInput::Up:
-		case UINavigationInput::Down:
-		case UINavigationInput::Back:
-		case UINavigationInput::Forward:
-		case UINavigationInput::PageUp:
-		case UINavigationInput::PageDown:
-		case UINavigationInput::PageLeft:
-		case UINavigationInput::PageRight:
-		case UINavigationInput::ScrollUp:
-		case UINavigationInput::ScrollDown:
-		case UINavigationInput::ScrollLeft:
-		case UINavigationInput::ScrollRight:
-			return true;
-
-		case UINavigationInput::Home:
-		case UINavigationInput::End:
-			return false;
-		}
-		return false;
+		return ParentSystem.ProcessedStickValue(*this, stick_num);
 	}
 
-	bool IXboxGamepadDevice::IsNavigationPressed(UINavigationInput input) const
+	vec2 IGamepadDevice::ProcessedStickValueLastFrame(uint8_t stick_num) const
 	{
-		switch (input)
-		{
-		case UINavigationInput::Accept: return IsInputPressed((size_t)XboxGamepadButton::A);
-		case UINavigationInput::Cancel: return IsInputPressed((size_t)XboxGamepadButton::B);
-		case UINavigationInput::Menu: return IsInputPressed((size_t)XboxGamepadButton::Start);
-		case UINavigationInput::View: return IsInputPressed((size_t)XboxGamepadButton::Back);
-		case UINavigationInput::Left: return IsInputPressed((size_t)XboxGamepadButton::Left);
-		case UINavigationInput::Right: return IsInputPressed((size_t)XboxGamepadButton::Right);
-		case UINavigationInput::Up: return IsInputPressed((size_t)XboxGamepadButton::Up);
-		case UINavigationInput::Down: return IsInputPressed((size_t)XboxGamepadButton::Down);
-		case UINavigationInput::Back: return IsInputPressed((size_t)XboxGamepadButton::LeftBumper);
-		case UINavigationInput::Forward: return IsInputPressed((size_t)XboxGamepadButton::RightBumper);
-		case UINavigationInput::PageUp: return StickAxisValue(0, 0) < -0.1;
-		case UINavigationInput::PageDown: return StickAxisValue(0, 0) > 0.1;
-		case UINavigationInput::PageLeft: return StickAxisValue(0, 1) < -0.1;
-		case UINavigationInput::PageRight: return StickAxisValue(0, 1) > 0.1;
-		case UINavigationInput::ScrollUp: return StickAxisValue(1, 0) < -0.1;
-		case UINavigationInput::ScrollDown:	return StickAxisValue(1, 0) > 0.1;
-		case UINavigationInput::ScrollLeft:	return StickAxisValue(1, 1) < -0.1;
-		case UINavigationInput::ScrollRight: return StickAxisValue(1, 1) > 0.1;
-
-		case UINavigationInput::Home:
-		case UINavigationInput::End:
-			return false;
-		}
-		return false;
+		return ParentSystem.ProcessedStickValue(*this, stick_num, true);
 	}
 
-	bool IXboxGamepadDevice::WasNavigationPressedLastFrame(UINavigationInput input) const
+	auto IXboxGamepadDevice::NavigationBindings() const -> std::span<NavigationBinding const>
 	{
-		switch (input)
-		{
-		case UINavigationInput::Accept: return WasInputPressedLastFrame((size_t)XboxGamepadButton::A);
-		case UINavigationInput::Cancel: return WasInputPressedLastFrame((size_t)XboxGamepadButton::B);
-		case UINavigationInput::Menu: return WasInputPressedLastFrame((size_t)XboxGamepadButton::Start);
-		case UINavigationInput::View: return WasInputPressedLastFrame((size_t)XboxGamepadButton::Back);
-		case UINavigationInput::Left: return WasInputPressedLastFrame((size_t)XboxGamepadButton::Left);
-		case UINavigationInput::Right: return WasInputPressedLastFrame((size_t)XboxGamepadButton::Right);
-		case UINavigationInput::Up: return WasInputPressedLastFrame((size_t)XboxGamepadButton::Up);
-		case UINavigationInput::Down: return WasInputPressedLastFrame((size_t)XboxGamepadButton::Down);
-		case UINavigationInput::Back: return WasInputPressedLastFrame((size_t)XboxGamepadButton::LeftBumper);
-		case UINavigationInput::Forward: return WasInputPressedLastFrame((size_t)XboxGamepadButton::RightBumper);
-		case UINavigationInput::PageUp: return StickAxisValueLastFrame(0, 0) < -0.1;
-		case UINavigationInput::PageDown: return StickAxisValueLastFrame(0, 0) > 0.1;
-		case UINavigationInput::PageLeft: return StickAxisValueLastFrame(0, 1) < -0.1;
-		case UINavigationInput::PageRight: return StickAxisValueLastFrame(0, 1) > 0.1;
-		case UINavigationInput::ScrollUp: return StickAxisValueLastFrame(1, 0) < -0.1;
-		case UINavigationInput::ScrollDown:	return StickAxisValueLastFrame(1, 0) > 0.1;
-		case UINavigationInput::ScrollLeft:	return StickAxisValueLastFrame(1, 1) < -0.1;
-		case UINavigationInput::ScrollRight: return StickAxisValueLastFrame(1, 1) > 0.1;
-
-		case UINavigationInput::Home:
-		case UINavigationInput::End:
-			return false;
-		}
-		return false;
+		static constexpr NavigationBinding bindings[] = {
+			{ UINavigationInput::Accept, (size_t)XboxGamepadButton::A },
+			{ UINavigationInput::Cancel, (size_t)XboxGamepadButton::B },
+			{ UINavigationInput::Menu, (size_t)XboxGamepadButton::Start },
+			{ UINavigationInput::View, (size_t)XboxGamepadButton::Back },
+			{ UINavigationInput::Left, (size_t)XboxGamepadButton::Left },
+			{ UINavigationInput::Right, (size_t)XboxGamepadButton::Right },
+			{ UINavigationInput::Up, (size_t)XboxGamepadButton::Up },
+			{ UINavigationInput::Down, (size_t)XboxGamepadButton::Down },
+			{ UINavigationInput::Back, (size_t)XboxGamepadButton::LeftBumper },
+			{ UINavigationInput::Forward, (size_t)XboxGamepadButton::RightBumper },
+			{ UINavigationInput::PageUp, (size_t)Axes::LeftStick_YAxis, -1 },
+			{ UINavigationInput::PageDown, (size_t)Axes::LeftStick_YAxis, 1 },
+			{ UINavigationInput::PageLeft, (size_t)Axes::LeftStick_XAxis, -1 },
+			{ UINavigationInput::PageRight, (size_t)Axes::LeftStick_XAxis, 1 },
+			{ UINavigationInput::ScrollUp, (size_t)Axes::RightStick_YAxis, -1 },
+			{ UINavigationInput::ScrollDown, (size_t)Axes::RightStick_YAxis, 1 },
+			{ UINavigationInput::ScrollLeft, (size_t)Axes::RightStick_XAxis, -1 },
+			{ UINavigationInput::ScrollRight, (size_t)Axes::RightStick_XAxis, 1 },
+		};
+		return bindings;
 	}
 
 	vec2 UINavigationInputToDirection(UINavigationInput input)
@@ -408,234 +303,361 @@ namespace libgameinput
 
 	void IInputDevice::ReportInvalidInput(size_t input) const
 	{
-		ParentSystem.ErrorReporter->NewError("Input is not valid")
+		ParentSystem.ErrorReporter->NewStructuredReport(ReportType::Error, "Input is not valid")
 			.Value("Input", input)
 			.Value("Device", Name())
 			.Perform();
 	}
 
-	std::map<size_t, IKeyboardDevice::KeyboardButtonDescriptor> IKeyboardDevice::mISOUSKeyboardButtons = [] {
-		using enum KeyboardButton;
-		static constexpr auto valid_keys = { A, B, C, D, E, F, G, H, I, J, K, L, M, N, O, P, Q, R, S, T, U, V, W, X, Y, Z,  _1, _2, _3, _4, _5, _6, _7, _8, _9, _0,  Return, Escape, Backspace, Tab, Space,  
-			Minus, Equals, LeftBracket, RightBracket, Backslash, Semicolon, Apostrophe, Grave, Comma, Period, Slash,  Capslock,  F1, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12,  
-			PrintScreen, ScrollLock, Pause, Insert, Home, PageUp, Delete, End, PageDown, Right, Left, Down, Up,  NumLock, KP_Divide, KP_Multiply, KP_Minus, KP_Plus, KP_Enter, 
-			KP_1, KP_2, KP_3, KP_4, KP_5, KP_6, KP_7, KP_8, KP_9, KP_0, KP_Period,  NonUSBackslash, Application, KP_Equals, F13, F14, F15, F16, F17, F18, F19, F20, F21, F22, F23, F24, 
-			Execute, Help, Menu, Select, Stop, Again, Undo, Cut, Copy, Paste, Find, Mute, VolumeUp, VolumeDown, KP_Comma, KP_Equals2,  International1, International2, International3, 
-			International4, International5, International6, International7, International8, International9, Lang1, Lang2, Lang3, Lang4, Lang5, Lang6, Lang7, Lang8, Lang9,  
-			AltErase, SysReq, Cancel, Clear, Prior, Return2, Separator, Out, Oper, ClearAgain, CrSel, ExSel,  KP_00, KP_000, ThousandsSeparator, DecimalSeparator, CurrencyUnit, 
-			CurrencySubunit, KP_LeftParen, KP_RightParen, KP_LeftBrace, KP_RightBrace, KP_Tab, KP_Backspace, KP_A, KP_B, KP_C, KP_D, KP_E, KP_F, KP_Xor, KP_Power, KP_Percent, 
-			KP_Less, KP_Greater, KP_Ampersand, KP_DblAmpersand, KP_VerticalBar, KP_DblVerticalBar, KP_Colon, KP_Hash, KP_Space, KP_At, KP_Exclam, KP_MemStore, KP_MemRecall, 
-			KP_MemClear, KP_MemAdd, KP_MemSubtract, KP_MemMultiply, KP_MemDivide, KP_PlusMinus, KP_Clear, KP_ClearEntry, KP_Binary, KP_Octal, KP_Decimal, KP_Hexadecimal,  
-			LeftCtrl, LeftShift, LeftAlt, LeftGUI, RightCtrl, RightShift, RightAlt, RightGUI
+	namespace
+	{
+		/// Positions are in key units, top-left of each key, on a full-size ISO/US keyboard (ISO-only keys share the slot of their US counterpart)
+		constexpr auto ISOUSKeyboardButtons = [] {
+			std::array<IKeyboardDevice::KeyboardButtonDescriptor, IKeyboardDevice::KeyboardButtonCount> result{};
+
+			result[4] = { "A", { 1.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_A.png" };
+			result[5] = { "B", { 6.25, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_B.png" };
+			result[6] = { "C", { 4.25, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_C.png" };
+			result[7] = { "D", { 3.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_D.png" };
+			result[8] = { "E", { 3.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_E.png" };
+			result[9] = { "F", { 4.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F.png" };
+			result[10] = { "G", { 5.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_G.png" };
+			result[11] = { "H", { 6.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_H.png" };
+			result[12] = { "I", { 8.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_I.png" };
+			result[13] = { "J", { 7.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_J.png" };
+			result[14] = { "K", { 8.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_K.png" };
+			result[15] = { "L", { 9.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_L.png" };
+			result[16] = { "M", { 8.25, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_M.png" };
+			result[17] = { "N", { 7.25, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_N.png" };
+			result[18] = { "O", { 9.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_O.png" };
+			result[19] = { "P", { 10.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_P.png" };
+			result[20] = { "Q", { 1.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Q.png" };
+			result[21] = { "R", { 4.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_R.png" };
+			result[22] = { "S", { 2.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_S.png" };
+			result[23] = { "T", { 5.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_T.png" };
+			result[24] = { "U", { 7.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_U.png" };
+			result[25] = { "V", { 5.25, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_V.png" };
+			result[26] = { "W", { 2.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_W.png" };
+			result[27] = { "X", { 3.25, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_X.png" };
+			result[28] = { "Y", { 6.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Y.png" };
+			result[29] = { "Z", { 2.25, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Z.png" };
+			result[30] = { "1", { 1, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_1.png" };
+			result[31] = { "2", { 2, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_2.png" };
+			result[32] = { "3", { 3, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_3.png" };
+			result[33] = { "4", { 4, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_4.png" };
+			result[34] = { "5", { 5, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_5.png" };
+			result[35] = { "6", { 6, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_6.png" };
+			result[36] = { "7", { 7, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_7.png" };
+			result[37] = { "8", { 8, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_8.png" };
+			result[38] = { "9", { 9, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_9.png" };
+			result[39] = { "0", { 10, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_0.png" };
+			result[40] = { "Return", { 12.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Enter.png" };
+			result[41] = { "Escape", { 0, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Esc.png" };
+			result[42] = { "Backspace", { 13, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Backspace.png" };
+			result[43] = { "Tab", { 0, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Tab.png" };
+			result[44] = { "Space", { 3.75, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Space.png" };
+			result[45] = { "-", { 11, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Minus.png" };
+			result[46] = { "=", { 12, 1.5 }, {} };
+			result[47] = { "[", { 11.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Bracket_Left.png" };
+			result[48] = { "]", { 12.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Bracket_Right.png" };
+			result[49] = { "\\", { 13.5, 2.5 }, {} };
+			result[50] = { "#", { 12.75, 3.5 }, {} };
+			result[51] = { ";", { 10.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Semicolon.png" };
+			result[52] = { "'", { 11.75, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Quote.png" };
+			result[53] = { "`", { 0, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Tilda.png" };
+			result[54] = { ",", { 9.25, 4.5 }, {} };
+			result[55] = { ".", { 10.25, 4.5 }, {} };
+			result[56] = { "/", { 11.25, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Slash.png" };
+			result[57] = { "CapsLock", { 0, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Caps_Lock.png" };
+			result[58] = { "F1", { 2, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F1.png" };
+			result[59] = { "F2", { 3, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F2.png" };
+			result[60] = { "F3", { 4, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F3.png" };
+			result[61] = { "F4", { 5, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F4.png" };
+			result[62] = { "F5", { 6.5, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F5.png" };
+			result[63] = { "F6", { 7.5, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F6.png" };
+			result[64] = { "F7", { 8.5, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F7.png" };
+			result[65] = { "F8", { 9.5, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F8.png" };
+			result[66] = { "F9", { 11, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F9.png" };
+			result[67] = { "F10", { 12, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F10.png" };
+			result[68] = { "F11", { 13, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F11.png" };
+			result[69] = { "F12", { 14, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_F12.png" };
+			result[70] = { "PrintScreen", { 15.25, 0 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Print_Screen.png" };
+			result[71] = { "ScrollLock", { 16.25, 0 }, {} };
+			result[72] = { "Pause", { 17.25, 0 }, {} };
+			result[73] = { "Insert", { 15.25, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Insert.png" };
+			result[74] = { "Home", { 16.25, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Home.png" };
+			result[75] = { "PageUp", { 17.25, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Page_Up.png" };
+			result[76] = { "Delete", { 15.25, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Del.png" };
+			result[77] = { "End", { 16.25, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_End.png" };
+			result[78] = { "PageDown", { 17.25, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Page_Down.png" };
+			result[79] = { "Right", { 17.25, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Arrow_Right.png" };
+			result[80] = { "Left", { 15.25, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Arrow_Left.png" };
+			result[81] = { "Down", { 16.25, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Arrow_Down.png" };
+			result[82] = { "Up", { 16.25, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Arrow_Up.png" };
+			result[83] = { "Numlock", { 18.5, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Num_Lock.png" };
+			result[84] = { "Keypad /", { 19.5, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Slash.png" };
+			result[85] = { "Keypad *", { 20.5, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Asterisk.png" };
+			result[86] = { "Keypad -", { 21.5, 1.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Minus.png" };
+			result[87] = { "Keypad +", { 21.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Plus_Tall.png" };
+			result[88] = { "Keypad Enter", { 21.5, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Enter_Tall.png" };
+			result[89] = { "Keypad 1", { 18.5, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_1.png" };
+			result[90] = { "Keypad 2", { 19.5, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_2.png" };
+			result[91] = { "Keypad 3", { 20.5, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_3.png" };
+			result[92] = { "Keypad 4", { 18.5, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_4.png" };
+			result[93] = { "Keypad 5", { 19.5, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_5.png" };
+			result[94] = { "Keypad 6", { 20.5, 3.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_6.png" };
+			result[95] = { "Keypad 7", { 18.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_7.png" };
+			result[96] = { "Keypad 8", { 19.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_8.png" };
+			result[97] = { "Keypad 9", { 20.5, 2.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_9.png" };
+			result[98] = { "Keypad 0", { 18.5, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_0.png" };
+			result[99] = { "Keypad .", { 20.5, 5.5 }, {} };
+			result[100] = { "Non-US \\", { 1.25, 4.5 }, {} }; /// left of Z on ISO keyboards
+			result[101] = { "Application", { 12.5, 5.5 }, {} };
+			result[102].Name = "Power";
+			result[103].Name = "Keypad =";
+			result[104].Name = "F13";
+			result[105].Name = "F14";
+			result[106].Name = "F15";
+			result[107].Name = "F16";
+			result[108].Name = "F17";
+			result[109].Name = "F18";
+			result[110].Name = "F19";
+			result[111].Name = "F20";
+			result[112].Name = "F21";
+			result[113].Name = "F22";
+			result[114].Name = "F23";
+			result[115].Name = "F24";
+			result[116].Name = "Execute";
+			result[117].Name = "Help";
+			result[118].Name = "Menu";
+			result[119].Name = "Select";
+			result[120].Name = "Stop";
+			result[121].Name = "Again";
+			result[122].Name = "Undo";
+			result[123].Name = "Cut";
+			result[124].Name = "Copy";
+			result[125].Name = "Paste";
+			result[126].Name = "Find";
+			result[127].Name = "Mute";
+			result[128].Name = "VolumeUp";
+			result[129].Name = "VolumeDown";
+
+			result[133].Name = "Keypad ,";
+			result[134].Name = "Keypad = (AS400)";
+			result[135].Name = "International1";
+			result[136].Name = "International2";
+			result[137].Name = "International3";
+			result[138].Name = "International4";
+			result[139].Name = "International5";
+			result[140].Name = "International6";
+			result[141].Name = "International7";
+			result[142].Name = "International8";
+			result[143].Name = "International9";
+			result[144].Name = "Lang1";
+			result[145].Name = "Lang2";
+			result[146].Name = "Lang3";
+			result[147].Name = "Lang4";
+			result[148].Name = "Lang5";
+			result[149].Name = "Lang6";
+			result[150].Name = "Lang7";
+			result[151].Name = "Lang8";
+			result[152].Name = "Lang9";
+			result[153].Name = "AltErase";
+			result[154].Name = "SysReq";
+			result[155].Name = "Cancel";
+			result[156].Name = "Clear";
+			result[157].Name = "Prior";
+			result[158].Name = "Return";
+			result[159].Name = "Separator";
+			result[160].Name = "Out";
+			result[161].Name = "Oper";
+			result[162].Name = "Clear / Again";
+			result[163].Name = "CrSel";
+			result[164].Name = "ExSel";
+
+			result[176].Name = "Keypad 00";
+			result[177].Name = "Keypad 000";
+			result[178].Name = "ThousandsSeparator";
+			result[179].Name = "DecimalSeparator";
+			result[180].Name = "CurrencyUnit";
+			result[181].Name = "CurrencySubUnit";
+			result[182].Name = "Keypad (";
+			result[183].Name = "Keypad )";
+			result[184].Name = "Keypad {";
+			result[185].Name = "Keypad }";
+			result[186].Name = "Keypad Tab";
+			result[187].Name = "Keypad Backspace";
+			result[188].Name = "Keypad A";
+			result[189].Name = "Keypad B";
+			result[190].Name = "Keypad C";
+			result[191].Name = "Keypad D";
+			result[192].Name = "Keypad E";
+			result[193].Name = "Keypad F";
+			result[194].Name = "Keypad XOR";
+			result[195].Name = "Keypad ^";
+			result[196].Name = "Keypad %";
+			result[197].Name = "Keypad <";
+			result[198].Name = "Keypad >";
+			result[199].Name = "Keypad &";
+			result[200].Name = "Keypad &&";
+			result[201].Name = "Keypad |";
+			result[202].Name = "Keypad ||";
+			result[203].Name = "Keypad :";
+			result[204].Name = "Keypad #";
+			result[205].Name = "Keypad Space";
+			result[206].Name = "Keypad @";
+			result[207].Name = "Keypad !";
+			result[208].Name = "Keypad MemStore";
+			result[209].Name = "Keypad MemRecall";
+			result[210].Name = "Keypad MemClear";
+			result[211].Name = "Keypad MemAdd";
+			result[212].Name = "Keypad MemSubtract";
+			result[213].Name = "Keypad MemMultiply";
+			result[214].Name = "Keypad MemDivide";
+			result[215].Name = "Keypad +/-";
+			result[216].Name = "Keypad Clear";
+			result[217].Name = "Keypad ClearEntry";
+			result[218].Name = "Keypad Binary";
+			result[219].Name = "Keypad Octal";
+			result[220].Name = "Keypad Decimal";
+			result[221].Name = "Keypad Hexadecimal";
+
+			result[224] = { "Left Ctrl", { 0, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Ctrl.png" };
+			result[225] = { "Left Shift", { 0, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Shift.png" };
+			result[226] = { "Left Alt", { 2.5, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Alt.png" };
+			result[227] = { "Left GUI", { 1.25, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Win.png" };
+			result[228] = { "Right Ctrl", { 13.75, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Ctrl.png" };
+			result[229] = { "Right Shift", { 12.25, 4.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Shift.png" };
+			result[230] = { "Right Alt", { 10, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Alt.png" };
+			result[231] = { "Right GUI", { 11.25, 5.5 }, "ControllerGraphics/Keyboard & Mouse/Dark/Keyboard_Black_Win.png" };
+
+			return result;
+		}();
+
+		/// FNV-1a, with the seed mixed into the offset basis
+		constexpr uint32_t KeyboardButtonNameHash(std::string_view name, uint32_t seed)
+		{
+			uint32_t hash = 2166136261u ^ (seed * 16777619u);
+			for (auto c : name)
+			{
+				hash ^= uint8_t(c);
+				hash *= 16777619u;
+			}
+			return hash;
+		}
+
+		/// A hash-and-displace perfect hash from key names to scancodes, built at compile time
+		struct KeyboardButtonNameTable
+		{
+			static constexpr size_t BucketCount = 128;
+			static constexpr size_t MaxBucketSize = 16;
+			static constexpr size_t SlotCount = 512;
+
+			std::array<uint16_t, BucketCount> Displacements{};
+			std::array<uint8_t, SlotCount> Scancodes{}; /// 0 (KeyboardButton::None) marks an empty slot
+
+			constexpr size_t SlotFor(std::string_view name) const
+			{
+				const auto bucket = KeyboardButtonNameHash(name, 0) % BucketCount;
+				return KeyboardButtonNameHash(name, Displacements[bucket]) % SlotCount;
+			}
+
+			template <typename DESCRIPTORS>
+			static constexpr auto Build(DESCRIPTORS const& descriptors) -> KeyboardButtonNameTable
+			{
+				KeyboardButtonNameTable result{};
+
+				std::array<std::array<uint8_t, MaxBucketSize>, BucketCount> buckets{};
+				std::array<size_t, BucketCount> bucket_sizes{};
+				for (size_t scancode = 1; scancode < descriptors.size(); ++scancode)
+				{
+					const auto name = descriptors[scancode].Name;
+					if (name.empty())
+						continue;
+
+					/// Duplicate names resolve to the lowest scancode
+					bool duplicate = false;
+					for (size_t other = 1; other < scancode && !duplicate; ++other)
+						duplicate = descriptors[other].Name == name;
+					if (duplicate)
+						continue;
+
+					const auto bucket = KeyboardButtonNameHash(name, 0) % BucketCount;
+					buckets[bucket][bucket_sizes[bucket]++] = uint8_t(scancode); /// fails to compile if a bucket overflows
+				}
+
+				/// Place the largest buckets first, while the table is still mostly empty
+				for (size_t size = MaxBucketSize; size > 0; --size)
+				{
+					for (size_t bucket = 0; bucket < BucketCount; ++bucket)
+					{
+						if (bucket_sizes[bucket] != size)
+							continue;
+
+						for (uint16_t displacement = 1; ; ++displacement) /// fails to compile if no displacement fits
+						{
+							std::array<size_t, MaxBucketSize> slots{};
+							bool fits = true;
+							for (size_t i = 0; i < size && fits; ++i)
+							{
+								slots[i] = KeyboardButtonNameHash(descriptors[buckets[bucket][i]].Name, displacement) % SlotCount;
+								fits = result.Scancodes[slots[i]] == 0;
+								for (size_t j = 0; j < i && fits; ++j)
+									fits = slots[j] != slots[i];
+							}
+
+							if (fits)
+							{
+								for (size_t i = 0; i < size; ++i)
+									result.Scancodes[slots[i]] = buckets[bucket][i];
+								result.Displacements[bucket] = displacement;
+								break;
+							}
+						}
+					}
+				}
+
+				return result;
+			}
 		};
 
-		std::map<size_t, IKeyboardDevice::KeyboardButtonDescriptor> result;
-		for (auto key : valid_keys)
-			result[size_t(key)] = {};
-
-		result[4].Name = "A";
-		result[5].Name = "B";
-		result[6].Name = "C";
-		result[7].Name = "D";
-		result[8].Name = "E";
-		result[9].Name = "F";
-		result[10].Name = "G";
-		result[11].Name = "H";
-		result[12].Name = "I";
-		result[13].Name = "J";
-		result[14].Name = "K";
-		result[15].Name = "L";
-		result[16].Name = "M";
-		result[17].Name = "N";
-		result[18].Name = "O";
-		result[19].Name = "P";
-		result[20].Name = "Q";
-		result[21].Name = "R";
-		result[22].Name = "S";
-		result[23].Name = "T";
-		result[24].Name = "U";
-		result[25].Name = "V";
-		result[26].Name = "W";
-		result[27].Name = "X";
-		result[28].Name = "Y";
-		result[29].Name = "Z";
-		result[30].Name = "1";
-		result[31].Name = "2";
-		result[32].Name = "3";
-		result[33].Name = "4";
-		result[34].Name = "5";
-		result[35].Name = "6";
-		result[36].Name = "7";
-		result[37].Name = "8";
-		result[38].Name = "9";
-		result[39].Name = "0";
-		result[40].Name = "Return";
-		result[41].Name = "Escape";
-		result[42].Name = "Backspace";
-		result[43].Name = "Tab";
-		result[44].Name = "Space";
-		result[45].Name = "-";
-		result[46].Name = "=";
-		result[47].Name = "[";
-		result[48].Name = "]";
-		result[49].Name = "\\";
-		result[50].Name = "#";
-		result[51].Name = ";";
-		result[52].Name = "'";
-		result[53].Name = "`";
-		result[54].Name = ",";
-		result[55].Name = ".";
-		result[56].Name = "/";
-		result[57].Name = "CapsLock";
-		result[58].Name = "F1";
-		result[59].Name = "F2";
-		result[60].Name = "F3";
-		result[61].Name = "F4";
-		result[62].Name = "F5";
-		result[63].Name = "F6";
-		result[64].Name = "F7";
-		result[65].Name = "F8";
-		result[66].Name = "F9";
-		result[67].Name = "F10";
-		result[68].Name = "F11";
-		result[69].Name = "F12";
-		result[70].Name = "PrintScreen";
-		result[71].Name = "ScrollLock";
-		result[72].Name = "Pause";
-		result[73].Name = "Insert";
-		result[74].Name = "Home";
-		result[75].Name = "PageUp";
-		result[76].Name = "Delete";
-		result[77].Name = "End";
-		result[78].Name = "PageDown";
-		result[79].Name = "Right";
-		result[80].Name = "Left";
-		result[81].Name = "Down";
-		result[82].Name = "Up";
-		result[83].Name = "Numlock";
-		result[84].Name = "Keypad /";
-		result[85].Name = "Keypad *";
-		result[86].Name = "Keypad -";
-		result[87].Name = "Keypad +";
-		result[88].Name = "Keypad Enter";
-		result[89].Name = "Keypad 1";
-		result[90].Name = "Keypad 2";
-		result[91].Name = "Keypad 3";
-		result[92].Name = "Keypad 4";
-		result[93].Name = "Keypad 5";
-		result[94].Name = "Keypad 6";
-		result[95].Name = "Keypad 7";
-		result[96].Name = "Keypad 8";
-		result[97].Name = "Keypad 9";
-		result[98].Name = "Keypad 0";
-		result[99].Name = "Keypad .";
-		
-		result[101].Name = "Application";
-		result[102].Name = "Power";
-		result[103].Name = "Keypad =";
-		result[104].Name = "F13";
-		result[105].Name = "F14";
-		result[106].Name = "F15";
-		result[107].Name = "F16";
-		result[108].Name = "F17";
-		result[109].Name = "F18";
-		result[110].Name = "F19";
-		result[111].Name = "F20";
-		result[112].Name = "F21";
-		result[113].Name = "F22";
-		result[114].Name = "F23";
-		result[115].Name = "F24";
-		result[116].Name = "Execute";
-		result[117].Name = "Help";
-		result[118].Name = "Menu";
-		result[119].Name = "Select";
-		result[120].Name = "Stop";
-		result[121].Name = "Again";
-		result[122].Name = "Undo";
-		result[123].Name = "Cut";
-		result[124].Name = "Copy";
-		result[125].Name = "Paste";
-		result[126].Name = "Find";
-		result[127].Name = "Mute";
-		result[128].Name = "VolumeUp";
-		result[129].Name = "VolumeDown";
-		
-		result[133].Name = "Keypad ,";
-		result[134].Name = "Keypad = (AS400)";
-		
-		result[153].Name = "AltErase";
-		result[154].Name = "SysReq";
-		result[155].Name = "Cancel";
-		result[156].Name = "Clear";
-		result[157].Name = "Prior";
-		result[158].Name = "Return";
-		result[159].Name = "Separator";
-		result[160].Name = "Out";
-		result[161].Name = "Oper";
-		result[162].Name = "Clear / Again";
-		result[163].Name = "CrSel";
-		result[164].Name = "ExSel";
-		
-		result[176].Name = "Keypad 00";
-		result[177].Name = "Keypad 000";
-		result[178].Name = "ThousandsSeparator";
-		result[179].Name = "DecimalSeparator";
-		result[180].Name = "CurrencyUnit";
-		result[181].Name = "CurrencySubUnit";
-		result[182].Name = "Keypad (";
-		result[183].Name = "Keypad )";
-		result[184].Name = "Keypad {";
-		result[185].Name = "Keypad }";
-		result[186].Name = "Keypad Tab";
-		result[187].Name = "Keypad Backspace";
-		result[188].Name = "Keypad A";
-		result[189].Name = "Keypad B";
-		result[190].Name = "Keypad C";
-		result[191].Name = "Keypad D";
-		result[192].Name = "Keypad E";
-		result[193].Name = "Keypad F";
-		result[194].Name = "Keypad XOR";
-		result[195].Name = "Keypad ^";
-		result[196].Name = "Keypad %";
-		result[197].Name = "Keypad <";
-		result[198].Name = "Keypad >";
-		result[199].Name = "Keypad &";
-		result[200].Name = "Keypad &&";
-		result[201].Name = "Keypad |";
-		result[202].Name = "Keypad ||";
-		result[203].Name = "Keypad :";
-		result[204].Name = "Keypad #";
-		result[205].Name = "Keypad Space";
-		result[206].Name = "Keypad @";
-		result[207].Name = "Keypad !";
-		result[208].Name = "Keypad MemStore";
-		result[209].Name = "Keypad MemRecall";
-		result[210].Name = "Keypad MemClear";
-		result[211].Name = "Keypad MemAdd";
-		result[212].Name = "Keypad MemSubtract";
-		result[213].Name = "Keypad MemMultiply";
-		result[214].Name = "Keypad MemDivide";
-		result[215].Name = "Keypad +/-";
-		result[216].Name = "Keypad Clear";
-		result[217].Name = "Keypad ClearEntry";
-		result[218].Name = "Keypad Binary";
-		result[219].Name = "Keypad Octal";
-		result[220].Name = "Keypad Decimal";
-		result[221].Name = "Keypad Hexadecimal";
-		
-		result[224].Name = "Left Ctrl";
-		result[225].Name = "Left Shift";
-		result[226].Name = "Left Alt";
-		result[227].Name = "Left GUI";
-		result[228].Name = "Right Ctrl";
-		result[229].Name = "Right Shift";
-		result[230].Name = "Right Alt";
-		result[231].Name = "Right GUI";
-
-		return result;
-	}();
+		constexpr auto ISOUSKeyboardButtonNames = KeyboardButtonNameTable::Build(ISOUSKeyboardButtons);
+	}
+
+	std::span<IKeyboardDevice::KeyboardButtonDescriptor const> const IKeyboardDevice::mISOUSKeyboardButtons = ISOUSKeyboardButtons;
 
-	vec3 IEyeTrackingDevice::EyeFocusPosition() const
+	auto IKeyboardDevice::ButtonDescriptor(KeyboardButton button) -> KeyboardButtonDescriptor const*
+	{
+		const auto scancode = size_t(button);
+		if (scancode < mISOUSKeyboardButtons.size() && !mISOUSKeyboardButtons[scancode].Name.empty())
+			return &mISOUSKeyboardButtons[scancode];
+		return nullptr;
+	}
+
+	auto IKeyboardDevice::ButtonFromName(std::string_view name) -> KeyboardButton
+	{
+		const auto scancode = ISOUSKeyboardButtonNames.Scancodes[ISOUSKeyboardButtonNames.SlotFor(name)];
+		if (scancode != 0 && mISOUSKeyboardButtons[scancode].Name == name)
+			return KeyboardButton(scancode);
+		return KeyboardButton::None;
+	}
+
+	auto IKeyboardDevice::ValidInputs() const -> std::span<InputProperties const>
+	{
+		static const auto input_properties = [] {
+			std::array<InputProperties, KeyboardButtonCount> result{};
+			for (size_t scancode = 0; scancode < KeyboardButtonCount; ++scancode)
+			{
+				auto& descriptor = mISOUSKeyboardButtons[scancode];
+				if (!descriptor.Name.empty())
+					result[scancode] = ButtonInputProperties{ descriptor.Name, std::string{ descriptor.URI } };
+			}
+			return result;
+		}();
+		return input_properties;
+	}
+
+	vec3 IEyeTrackingDevice::ComputeEyeFocusPosition() const
 	{
 		const auto left = LeftEye();
 		const auto right = RightEye();
@@ -644,7 +666,25 @@ namespace libgameinput
 		return { NAN, NAN, NAN };
 	}
 
-	auto IInputDevice::OutputPropertiesOf(size_t index) -> OutputProperties const*
+	vec3 IEyeTrackingDevice::EyeFocusPosition() const
+	{
+		if (mLastGazeSampleTime != TimePoint{})
+			return mEyeFocus;
+		return ComputeEyeFocusPosition();
+	}
+
+	void IEyeTrackingDevice::UpdateEyeFocus(TimePoint sample_time)
+	{
+		mEyeFocus = ComputeEyeFocusPosition();
+		if (std::isnan(mEyeFocus.x) || std::isnan(mEyeFocus.y) || std::isnan(mEyeFocus.z))
+			return;
+
+		const auto dt = mLastGazeSampleTime == TimePoint{} ? 0.0 : Seconds{ sample_time - mLastGazeSampleTime }.count();
+		mLastGazeSampleTime = sample_time;
+		mGazeFilter.Filter(mEyeFocus, dt);
+	}
+
+	auto IInputDevice::OutputPropertiesOf(size_t index) const -> OutputProperties const*
 	{
 		const auto props = ValidOutputs();
 		return index < props.size() ? &props[index] : nullptr;
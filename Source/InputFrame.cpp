@@ -0,0 +1,233 @@
+#include "InputFrame.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace libgameinput
+{
+	auto InputFrameLayout::MaxEncodedBits() const -> size_t
+	{
+		size_t player_bits = ButtonCount;
+		for (auto& axis : Axes)
+			player_bits += std::clamp<size_t>(axis.Bits, 2, 32);
+		return 1 + PlayerCount * player_bits;
+	}
+
+	auto InputFrame::Empty(InputFrameLayout const& layout) -> InputFrame
+	{
+		InputFrame result;
+		result.Buttons.assign(layout.PlayerCount, 0);
+		result.Axes.resize(layout.PlayerCount * layout.Axes.size());
+		for (size_t player = 0; player < layout.PlayerCount; ++player)
+			for (size_t axis = 0; axis < layout.Axes.size(); ++axis)
+				result.Axes[player * layout.Axes.size() + axis] = layout.Axes[axis].Neutral;
+		return result;
+	}
+
+	void InputFrame::SetButton(size_t player, size_t button, bool pressed)
+	{
+		if (button >= 64)
+			return;
+		if (player >= Buttons.size())
+			Buttons.resize(player + 1, 0);
+		Buttons[player] = (Buttons[player] & ~(uint64_t(1) << button)) | (uint64_t(pressed) << button);
+	}
+
+	namespace
+	{
+		struct BitWriter
+		{
+			std::vector<uint8_t>& Data;
+			size_t BitPosition = Data.size() * 8;
+
+			void Write(uint64_t value, size_t bits)
+			{
+				for (size_t written = 0; written < bits; )
+				{
+					if ((BitPosition & 7) == 0)
+						Data.push_back(0);
+					const auto bit_in_byte = BitPosition & 7;
+					const auto count = std::min<size_t>(8 - bit_in_byte, bits - written);
+					Data.back() |= uint8_t(((value >> written) & ((1u << count) - 1)) << bit_in_byte);
+					written += count;
+					BitPosition += count;
+				}
+			}
+		};
+
+		struct BitReader
+		{
+			std::span<uint8_t const> Data;
+			size_t BitPosition = 0;
+			bool Failed = false;
+
+			auto Read(size_t bits) -> uint64_t
+			{
+				if (BitPosition + bits > Data.size() * 8)
+				{
+					Failed = true;
+					return 0;
+				}
+
+				uint64_t value = 0;
+				for (size_t read = 0; read < bits; )
+				{
+					const auto bit_in_byte = BitPosition & 7;
+					const auto count = std::min<size_t>(8 - bit_in_byte, bits - read);
+					value |= uint64_t((Data[BitPosition >> 3] >> bit_in_byte) & ((1u << count) - 1)) << read;
+					read += count;
+					BitPosition += count;
+				}
+				return value;
+			}
+		};
+	}
+
+	InputFrameEncoder::InputFrameEncoder(InputFrameLayout layout)
+		: mLayout(std::move(layout))
+	{
+		mLayout.ButtonCount = std::min<uint8_t>(mLayout.ButtonCount, 64);
+		mButtonMask = mLayout.ButtonCount == 64 ? ~uint64_t{} : (uint64_t(1) << mLayout.ButtonCount) - 1;
+
+		/// Codes are symmetric around neutral, so that it is exactly representable; the side with the larger range sets the step size
+		for (auto& axis : mLayout.Axes)
+		{
+			AxisCodec codec;
+			codec.Bits = std::clamp<uint8_t>(axis.Bits, 2, 32);
+			const auto half_steps = (int64_t(1) << (codec.Bits - 1)) - 1;
+			const auto range = std::max(axis.Max - axis.Neutral, axis.Neutral - axis.Min);
+			codec.Neutral = axis.Neutral;
+			codec.Scale = range > 0 && std::isfinite(range) ? range / double(half_steps) : 1.0;
+			codec.MinCode = -half_steps;
+			codec.MaxCode = half_steps;
+			mAxisCodecs.push_back(codec);
+		}
+	}
+
+	auto InputFrameEncoder::QuantizeAxis(size_t axis, double value) const -> uint32_t
+	{
+		auto& codec = mAxisCodecs[axis];
+		auto code = std::isfinite(value) ? std::llround((value - codec.Neutral) / codec.Scale) : 0;
+		code = std::clamp<int64_t>(code, codec.MinCode, codec.MaxCode);
+		return uint32_t(code - codec.MinCode);
+	}
+
+	auto InputFrameEncoder::DequantizeAxis(size_t axis, uint32_t code) const -> double
+	{
+		auto& codec = mAxisCodecs[axis];
+		const auto signed_code = std::clamp<int64_t>(int64_t(code) + codec.MinCode, codec.MinCode, codec.MaxCode);
+		return codec.Neutral + double(signed_code) * codec.Scale;
+	}
+
+	/// Format, LSB first:
+	///		1 bit: is delta
+	///		full frames, per player: buttons, then axis codes
+	///		delta frames, per player: 1 bit "changed"; if changed: 1 bit "buttons changed" (+ buttons), then per axis 1 bit "changed" (+ code)
+	void InputFrameEncoder::Encode(InputFrame const& frame, InputFrame const* reference, std::vector<uint8_t>& out) const
+	{
+		const auto axis_count = mLayout.Axes.size();
+		const auto buttons_of = [&](InputFrame const& f, size_t player) { return player < f.Buttons.size() ? f.Buttons[player] & mButtonMask : 0; };
+		const auto code_of = [&](InputFrame const& f, size_t player, size_t axis) {
+			const auto index = player * axis_count + axis;
+			return QuantizeAxis(axis, index < f.Axes.size() ? f.Axes[index] : mLayout.Axes[axis].Neutral);
+		};
+
+		BitWriter writer{ out };
+		writer.Write(reference != nullptr, 1);
+		for (size_t player = 0; player < mLayout.PlayerCount; ++player)
+		{
+			const auto buttons = buttons_of(frame, player);
+			if (!reference)
+			{
+				writer.Write(buttons, mLayout.ButtonCount);
+				for (size_t axis = 0; axis < axis_count; ++axis)
+					writer.Write(code_of(frame, player, axis), mAxisCodecs[axis].Bits);
+				continue;
+			}
+
+			const bool buttons_changed = buttons != buttons_of(*reference, player);
+			bool any_axis_changed = false;
+			for (size_t axis = 0; axis < axis_count && !any_axis_changed; ++axis)
+				any_axis_changed = code_of(frame, player, axis) != code_of(*reference, player, axis);
+
+			writer.Write(buttons_changed || any_axis_changed, 1);
+			if (!buttons_changed && !any_axis_changed)
+				continue;
+
+			writer.Write(buttons_changed, 1);
+			if (buttons_changed)
+				writer.Write(buttons, mLayout.ButtonCount);
+			for (size_t axis = 0; axis < axis_count; ++axis)
+			{
+				const auto code = code_of(frame, player, axis);
+				const bool changed = code != code_of(*reference, player, axis);
+				writer.Write(changed, 1);
+				if (changed)
+					writer.Write(code, mAxisCodecs[axis].Bits);
+			}
+		}
+	}
+
+	auto InputFrameEncoder::Encode(InputFrame const& frame, InputFrame const* reference) const -> std::vector<uint8_t>
+	{
+		std::vector<uint8_t> result;
+		result.reserve((mLayout.MaxEncodedBits() + 7) / 8);
+		Encode(frame, reference, result);
+		return result;
+	}
+
+	auto InputFrameEncoder::Decode(std::span<uint8_t const> data, InputFrame const* reference) const -> std::optional<InputFrame>
+	{
+		const auto axis_count = mLayout.Axes.size();
+		BitReader reader{ data };
+
+		const bool is_delta = reader.Read(1);
+		if (reader.Failed || (is_delta && !reference))
+			return std::nullopt;
+
+		auto result = is_delta ? Quantize(*reference) : InputFrame::Empty(mLayout);
+		for (size_t player = 0; player < mLayout.PlayerCount; ++player)
+		{
+			if (is_delta)
+			{
+				if (!reader.Read(1))
+					continue;
+				if (reader.Read(1))
+					result.Buttons[player] = reader.Read(mLayout.ButtonCount);
+				for (size_t axis = 0; axis < axis_count; ++axis)
+				{
+					if (reader.Read(1))
+						result.Axes[player * axis_count + axis] = DequantizeAxis(axis, uint32_t(reader.Read(mAxisCodecs[axis].Bits)));
+				}
+			}
+			else
+			{
+				result.Buttons[player] = reader.Read(mLayout.ButtonCount);
+				for (size_t axis = 0; axis < axis_count; ++axis)
+					result.Axes[player * axis_count + axis] = DequantizeAxis(axis, uint32_t(reader.Read(mAxisCodecs[axis].Bits)));
+			}
+
+			if (reader.Failed)
+				return std::nullopt;
+		}
+
+		return result;
+	}
+
+	auto InputFrameEncoder::Quantize(InputFrame const& frame) const -> InputFrame
+	{
+		const auto axis_count = mLayout.Axes.size();
+		auto result = InputFrame::Empty(mLayout);
+		for (size_t player = 0; player < mLayout.PlayerCount; ++player)
+		{
+			result.Buttons[player] = player < frame.Buttons.size() ? frame.Buttons[player] & mButtonMask : 0;
+			for (size_t axis = 0; axis < axis_count; ++axis)
+			{
+				const auto index = player * axis_count + axis;
+				if (index < frame.Axes.size())
+					result.Axes[index] = DequantizeAxis(axis, QuantizeAxis(axis, frame.Axes[index]));
+			}
+		}
+		return result;
+	}
+}
@@ -0,0 +1,147 @@
+#include "InputHistory.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace libgameinput
+{
+	InputHistory::InputHistory(InputFrameLayout const& layout, size_t capacity)
+		: mLayout(layout)
+		, mSlots(std::max<size_t>(capacity, 1))
+	{
+		mLayout.PlayerCount = std::min<uint8_t>(mLayout.PlayerCount, 64);
+	}
+
+	auto InputHistory::SlotFor(uint64_t tick) -> Slot&
+	{
+		auto& slot = mSlots[tick % mSlots.size()];
+		if (slot.Tick != tick)
+		{
+			slot.Tick = tick;
+			slot.ConfirmedPlayers = slot.PredictedPlayers = 0;
+			slot.Frame = InputFrame::Empty(mLayout);
+		}
+		mNewestTick = std::max(mNewestTick, tick);
+		return slot;
+	}
+
+	auto InputHistory::FindSlot(uint64_t tick) const -> Slot const*
+	{
+		auto& slot = mSlots[tick % mSlots.size()];
+		return slot.Tick == tick ? &slot : nullptr;
+	}
+
+	void InputHistory::CopyPlayer(InputFrame& to, InputFrame const& from, size_t player) const
+	{
+		const auto axis_count = mLayout.Axes.size();
+		to.Buttons[player] = player < from.Buttons.size() ? from.Buttons[player] : 0;
+		for (size_t axis = 0; axis < axis_count; ++axis)
+		{
+			const auto index = player * axis_count + axis;
+			to.Axes[index] = index < from.Axes.size() ? from.Axes[index] : mLayout.Axes[axis].Neutral;
+		}
+	}
+
+	bool InputHistory::PlayerEquals(InputFrame const& a, InputFrame const& b, size_t player) const
+	{
+		const auto axis_count = mLayout.Axes.size();
+		if (a.Buttons[player] != b.Buttons[player])
+			return false;
+		return std::equal(a.Axes.begin() + player * axis_count, a.Axes.begin() + (player + 1) * axis_count, b.Axes.begin() + player * axis_count);
+	}
+
+	void InputHistory::Predict(Slot& slot, size_t player)
+	{
+		/// Repeat the newest confirmed input before this tick; with none, predict a neutral input
+		const auto oldest = slot.Tick >= mSlots.size() ? slot.Tick - mSlots.size() + 1 : 0;
+		for (auto tick = slot.Tick; tick-- > oldest; )
+		{
+			if (auto previous = FindSlot(tick); previous && (previous->ConfirmedPlayers >> player) & 1)
+			{
+				CopyPlayer(slot.Frame, previous->Frame, player);
+				slot.PredictedPlayers |= uint64_t(1) << player;
+				return;
+			}
+		}
+		CopyPlayer(slot.Frame, InputFrame::Empty(mLayout), player);
+		slot.PredictedPlayers |= uint64_t(1) << player;
+	}
+
+	bool InputHistory::SetInput(uint64_t tick, size_t player, InputFrame const& from_frame)
+	{
+		if (player >= mLayout.PlayerCount || tick + mSlots.size() <= mNewestTick)
+			return false;
+
+		auto& slot = SlotFor(tick);
+		const auto bit = uint64_t(1) << player;
+		const bool was_predicted = (slot.PredictedPlayers & bit) && !(slot.ConfirmedPlayers & bit);
+
+		auto previous = InputFrame::Empty(mLayout);
+		CopyPlayer(previous, slot.Frame, player);
+		CopyPlayer(slot.Frame, from_frame, player);
+		slot.ConfirmedPlayers |= bit;
+		slot.PredictedPlayers &= ~bit;
+
+		const bool mispredicted = was_predicted && !PlayerEquals(previous, slot.Frame, player);
+		if (mispredicted)
+			mRollbackTick = std::min(mRollbackTick.value_or(tick), tick);
+
+		/// Later ticks may have predicted from an older input
+		for (auto later = tick + 1; later <= mNewestTick; ++later)
+		{
+			auto& later_slot = mSlots[later % mSlots.size()];
+			if (later_slot.Tick == later && (later_slot.PredictedPlayers & bit))
+			{
+				CopyPlayer(previous, later_slot.Frame, player);
+				Predict(later_slot, player);
+				if (!PlayerEquals(previous, later_slot.Frame, player))
+					mRollbackTick = std::min(mRollbackTick.value_or(later), later);
+			}
+		}
+
+		return mispredicted;
+	}
+
+	bool InputHistory::SetInput(uint64_t tick, size_t player, uint64_t buttons, std::span<double const> axes)
+	{
+		auto frame = InputFrame::Empty(mLayout);
+		if (player >= mLayout.PlayerCount)
+			return false;
+		frame.Buttons[player] = buttons;
+		const auto axis_count = mLayout.Axes.size();
+		std::copy_n(axes.begin(), std::min(axes.size(), axis_count), frame.Axes.begin() + player * axis_count);
+		return SetInput(tick, player, frame);
+	}
+
+	auto InputHistory::Frame(uint64_t tick) -> InputFrame const*
+	{
+		if (tick + mSlots.size() <= mNewestTick)
+			return nullptr;
+
+		auto& slot = SlotFor(tick);
+		for (size_t player = 0; player < mLayout.PlayerCount; ++player)
+		{
+			if (!((slot.ConfirmedPlayers >> player) & 1))
+				Predict(slot, player);
+		}
+		return &slot.Frame;
+	}
+
+	bool InputHistory::IsConfirmed(uint64_t tick, size_t player) const
+	{
+		auto slot = FindSlot(tick);
+		return slot && player < 64 && ((slot->ConfirmedPlayers >> player) & 1);
+	}
+
+	bool InputHistory::IsComplete(uint64_t tick) const
+	{
+		const auto all = mLayout.PlayerCount == 64 ? ~uint64_t{} : (uint64_t(1) << mLayout.PlayerCount) - 1;
+		auto slot = FindSlot(tick);
+		return slot && (slot->ConfirmedPlayers & all) == all;
+	}
+
+	auto InputHistory::TakeRollbackTick() -> std::optional<uint64_t>
+	{
+		return std::exchange(mRollbackTick, std::nullopt);
+	}
+}
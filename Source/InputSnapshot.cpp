@@ -0,0 +1,131 @@
+#include "InputSystem.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace libgameinput
+{
+	auto InputSnapshot::ActionOf(Input const& input) const -> IInputSystem::ResolvedAction const*
+	{
+		if (!mActionKeys)
+			return nullptr;
+
+		/// Keys are in the order the actions were compiled in, which is sorted by player, then action id
+		const auto less = [](IInputSystem::SnapshotActionKey const& key, Input const& input) {
+			return std::tuple{ key.Player, std::string_view{ key.ActionID } } < std::tuple{ input.Player, std::string_view{ input.ActionID } };
+		};
+		auto& keys = *mActionKeys;
+		const auto it = std::lower_bound(keys.begin(), keys.end(), input, less);
+		if (it == keys.end() || it->Player != input.Player || it->ActionID != input.ActionID)
+			return nullptr;
+		const auto index = size_t(it - keys.begin());
+		return index < mActions.size() ? &mActions[index] : nullptr;
+	}
+
+	bool InputSnapshot::IsButtonPressed(Input const& input_id) const
+	{
+		if (auto action = ActionOf(input_id))
+			return action->Pressed;
+		return false;
+	}
+
+	bool InputSnapshot::WasButtonPressed(Input const& input_id) const
+	{
+		if (auto action = ActionOf(input_id))
+			return action->Pressed && !action->PressedLastFrame;
+		return false;
+	}
+
+	bool InputSnapshot::WasButtonReleased(Input const& input_id) const
+	{
+		if (auto action = ActionOf(input_id))
+			return !action->Pressed && action->PressedLastFrame;
+		return false;
+	}
+
+	float InputSnapshot::AxisValue(Input const& of_input) const
+	{
+		if (auto action = ActionOf(of_input))
+			return (float)action->SmoothedValue.x;
+		return 0.0f;
+	}
+
+	vec2 InputSnapshot::Axis2DValue(Input const& of_input) const
+	{
+		if (auto action = ActionOf(of_input))
+			return action->SmoothedValue;
+		return {};
+	}
+
+	void IInputSystem::PublishSnapshot()
+	{
+		if (mMappingsChanged || mMappingsStale)
+			ResolveMappings();
+
+		if (mSnapshotPool.empty())
+		{
+			for (size_t i = 0; i < InitialSnapshotPoolSize; ++i)
+				mSnapshotPool.push_back(std::make_unique<InputSnapshot>());
+		}
+
+		/// A buffer can be refilled once it is not published and has no readers; a reader that grabs it in the meantime
+		/// will see that it is no longer published, and retry (see `AcquireSnapshot`)
+		const auto published = mPublishedSnapshot.load(std::memory_order_relaxed);
+		InputSnapshot* snapshot = nullptr;
+		for (auto& buffer : mSnapshotPool)
+		{
+			if (buffer.get() != published && buffer->mReaders.load(std::memory_order_seq_cst) == 0)
+			{
+				snapshot = buffer.get();
+				break;
+			}
+		}
+		if (!snapshot)
+			snapshot = mSnapshotPool.emplace_back(std::make_unique<InputSnapshot>()).get();
+
+		snapshot->mFrameNumber = mFrameNumber;
+		snapshot->mActionKeys = mSnapshotActionKeys;
+		snapshot->mActions.assign(mResolvedActions.begin(), mResolvedActions.end());
+
+		snapshot->mKeys.reset();
+		snapshot->mKeysLastFrame.reset();
+		if (auto keyboard = Keyboard())
+		{
+			for (size_t key = 0; key < IKeyboardDevice::KeyboardButtonCount; ++key)
+			{
+				snapshot->mKeys[key] = keyboard->IsInputPressed(key);
+				snapshot->mKeysLastFrame[key] = keyboard->WasInputPressedLastFrame(key);
+			}
+		}
+
+		snapshot->mMouseButtons.reset();
+		snapshot->mMouseButtonsLastFrame.reset();
+		snapshot->mMousePosition = {};
+		if (auto mouse = Mouse())
+		{
+			for (size_t button = 0; button <= (size_t)MouseButton::Button5; ++button)
+			{
+				snapshot->mMouseButtons[button] = mouse->IsInputPressed(button);
+				snapshot->mMouseButtonsLastFrame[button] = mouse->WasInputPressedLastFrame(button);
+			}
+			snapshot->mMousePosition = MousePosition();
+		}
+
+		mPublishedSnapshot.store(snapshot, std::memory_order_seq_cst);
+	}
+
+	auto IInputSystem::AcquireSnapshot() const -> InputSnapshotRef
+	{
+		while (true)
+		{
+			const auto snapshot = mPublishedSnapshot.load(std::memory_order_seq_cst);
+			if (!snapshot)
+				return {};
+
+			snapshot->mReaders.fetch_add(1, std::memory_order_seq_cst);
+			if (mPublishedSnapshot.load(std::memory_order_seq_cst) == snapshot)
+				return InputSnapshotRef{ snapshot };
+			snapshot->mReaders.fetch_sub(1, std::memory_order_release);
+		}
+	}
+}
@@ -1,6 +1,8 @@
 #include "InputSystem.h"
 //#include "../Debugger.h"
 
+#include <cstring>
+
 namespace libgameinput
 {
 	IInputSystem::IInputSystem(std::shared_ptr<IErrorReporter> error_reporter) noexcept
@@ -9,13 +11,239 @@ namespace libgameinput
 
 	}
 
+	IInputSystem::~IInputSystem() = default;
+
 	void IInputSystem::SetLastActiveDevice(IInputDevice* device, TimePoint current_time)
 	{
 		if (device)
 			device->SetLastActiveTime(current_time);
+		if (mLastActiveDevice != device)
+			mButtonNameCache.clear();
 		mLastActiveDevice = device;
 	}
 
+	void IInputSystem::InputDevicesChanged()
+	{
+		InvalidatePromptCache();
+		RebuildAnalogChannels();
+		RebuildNavigationTables();
+		mOutputs.RemoveDevicesExcept(mInputDevices);
+		if (mGlyphAtlas)
+			mGlyphAtlas->BindDevices(mInputDevices);
+		mMappingsChanged = true;
+	}
+
+	void IInputSystem::RebuildNavigationTables()
+	{
+		mNavigationTables.resize(mInputDevices.size());
+		for (InputDeviceIndex index = 0; index < mInputDevices.size(); ++index)
+		{
+			auto& table = mNavigationTables[index];
+			table.clear();
+			if (!mInputDevices[index])
+				continue;
+			for (auto const& binding : mInputDevices[index]->NavigationBindings())
+			{
+				if (!mNavigationMappings.contains({ index, binding.Navigation }))
+					table.push_back(binding);
+			}
+		}
+		for (auto const& [key, bindings] : mNavigationMappings)
+		{
+			if (key.first < mInputDevices.size() && mInputDevices[key.first])
+				mNavigationTables[key.first].insert(mNavigationTables[key.first].end(), bindings.begin(), bindings.end());
+		}
+	}
+
+	void IInputSystem::MappingsChanged()
+	{
+		mMappingsChanged = true;
+		InvalidatePromptCache();
+	}
+
+	void IInputSystem::RebuildAnalogChannels()
+	{
+		mAnalogProcessor.Clear();
+		mAnalogChannelSources.clear();
+		mAnalogChannelsOfDevice.assign(mInputDevices.size(), {});
+
+		for (InputDeviceIndex device_index = 0; device_index < mInputDevices.size(); ++device_index)
+		{
+			auto& device = mInputDevices[device_index];
+			if (!device)
+				continue;
+
+			const auto inputs = device->ValidInputs();
+			auto& channels = mAnalogChannelsOfDevice[device_index];
+			channels.assign(inputs.size(), InvalidIndex);
+			for (size_t input = 0; input < inputs.size(); ++input)
+			{
+				auto& props = inputs[input];
+				if (props.Flags.contains(InputFlags::Digital) || !props.Flags.contains(InputFlags::ReturnsToNeutral))
+					continue;
+				/// Stepped inputs (like a contact count) are counts or positions, not magnitudes to rescale
+				if (props.StepSize > 0)
+					continue;
+				if (!std::isfinite(props.MinValue) || !std::isfinite(props.MaxValue))
+					continue;
+
+				const auto override_it = mAnalogSettings.find({ device_index, input });
+				const auto settings = override_it != mAnalogSettings.end() ? override_it->second : AnalogChannelSettings::FromProperties(props);
+				channels[input] = mAnalogProcessor.ChannelCount();
+				for (const bool last_frame : { false, true })
+				{
+					mAnalogProcessor.AddChannel(settings);
+					mAnalogChannelSources.push_back({ device_index, input, last_frame });
+				}
+			}
+		}
+
+		mStickProcessor.Clear();
+		mStickSources.clear();
+		for (InputDeviceIndex device_index = 0; device_index < mInputDevices.size(); ++device_index)
+		{
+			auto gamepad = dynamic_cast<IGamepadDevice*>(mInputDevices[device_index].get());
+			if (!gamepad)
+				continue;
+
+			gamepad->mFirstStickSlot = mStickProcessor.StickCount();
+			for (uint8_t stick = 0; stick < gamepad->StickCount(); ++stick)
+			{
+				for (const bool last_frame : { false, true })
+				{
+					mStickProcessor.AddStick(StickDeadZoneOf(device_index, stick));
+					mStickSources.push_back({ gamepad, device_index, stick, last_frame });
+				}
+			}
+		}
+
+		mAnalogInputsStale = true;
+	}
+
+	auto IInputSystem::StickDeadZoneOf(InputDeviceIndex device, uint8_t stick) const -> StickDeadZoneSettings const&
+	{
+		if (auto it = mStickDeadZones.find({ device, stick }); it != mStickDeadZones.end())
+			return it->second;
+		return mDefaultStickDeadZone;
+	}
+
+	auto IInputSystem::AnalogChannelOf(InputDeviceIndex device, size_t input) const -> size_t
+	{
+		if (device < mAnalogChannelsOfDevice.size() && input < mAnalogChannelsOfDevice[device].size())
+			return mAnalogChannelsOfDevice[device][input];
+		return InvalidIndex;
+	}
+
+	void IInputSystem::ProcessAnalogInputs()
+	{
+		const auto raw = mAnalogProcessor.RawValues();
+		for (size_t channel = 0; channel < mAnalogChannelSources.size(); ++channel)
+		{
+			auto& source = mAnalogChannelSources[channel];
+			auto device = InputDevice(source.Device);
+			if (device)
+				raw[channel] = (float)(source.LastFrame ? device->InputValueLastFrame(source.Input) : device->InputValue(source.Input));
+			else
+				raw[channel] = 0.0f;
+		}
+		mAnalogProcessor.Process();
+
+		const auto raw_x = mStickProcessor.RawX();
+		const auto raw_y = mStickProcessor.RawY();
+		for (size_t slot = 0; slot < mStickSources.size(); ++slot)
+		{
+			auto& source = mStickSources[slot];
+			const auto value = source.LastFrame ? source.Gamepad->StickValueLastFrame(source.Stick) : source.Gamepad->StickValue(source.Stick);
+			raw_x[slot] = (float)value.x;
+			raw_y[slot] = (float)value.y;
+		}
+		mStickProcessor.Process();
+
+		mAnalogInputsStale = false;
+	}
+
+	void IInputSystem::ProcessLateLatchedAnalogInputs()
+	{
+		const auto raw = mAnalogProcessor.RawValues();
+		for (auto channel : mLateLatchChannels)
+		{
+			auto& source = mAnalogChannelSources[channel];
+			auto device = InputDevice(source.Device);
+			raw[channel] = device ? (float)device->InputValue(source.Input) : 0.0f;
+		}
+		mAnalogProcessor.Process(mLateLatchChannels);
+
+		const auto raw_x = mStickProcessor.RawX();
+		const auto raw_y = mStickProcessor.RawY();
+		for (auto slot : mLateLatchStickSlots)
+		{
+			auto& source = mStickSources[slot];
+			const auto value = source.Gamepad->StickValue(source.Stick);
+			raw_x[slot] = (float)value.x;
+			raw_y[slot] = (float)value.y;
+		}
+		mStickProcessor.Process(mLateLatchStickSlots);
+	}
+
+	vec2 IInputSystem::ProcessedStickValue(IGamepadDevice const& gamepad, uint8_t stick_num, bool last_frame)
+	{
+		if (gamepad.mFirstStickSlot == InvalidIndex || stick_num >= gamepad.StickCount())
+			return {};
+
+		const auto slot = gamepad.mFirstStickSlot + stick_num * 2 + size_t(last_frame);
+		if (slot >= mStickProcessor.StickCount())
+			return {};
+
+		if (mAnalogInputsStale)
+			ProcessAnalogInputs();
+		return { mStickProcessor.ResultX()[slot], mStickProcessor.ResultY()[slot] };
+	}
+
+	void IInputSystem::SetStickDeadZone(InputDeviceIndex of_gamepad, uint8_t stick_num, StickDeadZoneSettings const& settings)
+	{
+		mStickDeadZones[{ of_gamepad, stick_num }] = settings;
+		for (size_t slot = 0; slot < mStickSources.size(); ++slot)
+		{
+			if (mStickSources[slot].Device == of_gamepad && mStickSources[slot].Stick == stick_num)
+				mStickProcessor.Configure(slot, settings);
+		}
+		mAnalogInputsStale = true;
+	}
+
+	void IInputSystem::SetDefaultStickDeadZone(StickDeadZoneSettings const& settings)
+	{
+		mDefaultStickDeadZone = settings;
+		for (size_t slot = 0; slot < mStickSources.size(); ++slot)
+			mStickProcessor.Configure(slot, StickDeadZoneOf(mStickSources[slot].Device, mStickSources[slot].Stick));
+		mAnalogInputsStale = true;
+	}
+
+	double IInputSystem::ProcessedInputValue(InputDeviceIndex of_device, size_t input, bool last_frame)
+	{
+		const auto channel = AnalogChannelOf(of_device, input);
+		if (channel == InvalidIndex)
+		{
+			if (auto device = InputDevice(of_device))
+				return last_frame ? device->InputValueLastFrame(input) : device->InputValue(input);
+			return 0.0;
+		}
+
+		if (mAnalogInputsStale)
+			ProcessAnalogInputs();
+		return mAnalogProcessor.Results()[channel + size_t(last_frame)];
+	}
+
+	void IInputSystem::SetAnalogSettings(InputDeviceIndex of_device, size_t input, AnalogChannelSettings const& settings)
+	{
+		mAnalogSettings[{ of_device, input }] = settings;
+		if (const auto channel = AnalogChannelOf(of_device, input); channel != InvalidIndex)
+		{
+			mAnalogProcessor.Configure(channel, settings);
+			mAnalogProcessor.Configure(channel + 1, settings);
+			mAnalogInputsStale = true;
+		}
+	}
+
 	void IInputSystem::Init()
 	{
 		SetLastActiveDevice(Keyboard(), {});
@@ -23,10 +251,29 @@ namespace libgameinput
 
 	void IInputSystem::Update()
 	{
+		/// Events of the ending frame have all been processed by now, so this is its final state
+		PublishSnapshot();
+
+		/// Sampled before `NewFrame()` clears the inputs that only last a frame (wheel and mouse deltas, click counts, gestures);
+		/// whatever changed since the last frame could have changed right after it, so that is when the changes are stamped
+		const auto now = std::chrono::high_resolution_clock::now();
+		if (mTickSampling && !mMappingsChanged)
+		{
+			mAnalogInputsStale = true;
+			SampleTickChanges(mLastUpdateTime);
+		}
+		mLastUpdateTime = now;
+
 		for (auto& device : mInputDevices)
 		{
 			if (device) device->NewFrame();
 		}
+		mAnalogInputsStale = true;
+		mMappingsStale = true;
+		mInjectedNavigationLastFrame = mInjectedNavigation;
+		++mFrameNumber;
+
+		mOutputs.Flush(now);
 	}
 
 
@@ -35,24 +282,737 @@ namespace libgameinput
 		//if (of_device >= mInputDevices.size())
 			//Game->Warning("Input device index {} does not represent a connected device", of_device);
 		mPlayers[to_input.Player].Mappings[to_input.ActionID].push_back(Mapping{ of_device, {physical_button, InvalidIndex} });
+		MappingsChanged();
 	}
 
-	bool IInputSystem::IsButtonPressed(Input input_id)
+	void IInputSystem::MapAxis1D(size_t physical_axis, InputDeviceIndex of_device, Input to_input)
+	{
+		mPlayers[to_input.Player].Mappings[to_input.ActionID].push_back(Mapping{ of_device, {physical_axis, InvalidIndex}, MappingType::Axis1D });
+		MappingsChanged();
+	}
+
+	void IInputSystem::MapAxis2D(size_t physical_axis1, size_t physical_axis2, InputDeviceIndex of_device, Input to_input)
+	{
+		mPlayers[to_input.Player].Mappings[to_input.ActionID].push_back(Mapping{ of_device, {physical_axis1, physical_axis2}, MappingType::Axis2D });
+		MappingsChanged();
+	}
+
+	void IInputSystem::MapAxisToButton(size_t physical_axis, InputDeviceIndex of_device, double press_threshold, double release_threshold, Input to_input)
+	{
+		Mapping mapping{ of_device, {physical_axis, InvalidIndex}, MappingType::AxisToButton };
+		mapping.PressThreshold = press_threshold;
+		mapping.ReleaseThreshold = release_threshold;
+		mPlayers[to_input.Player].Mappings[to_input.ActionID].push_back(mapping);
+		MappingsChanged();
+	}
+
+	void IInputSystem::MapButtonToAxis(size_t physical_button, InputDeviceIndex of_device, double to_pressed_value, double and_released_value, Input of_input)
+	{
+		mPlayers[of_input.Player].Mappings[of_input.ActionID].push_back(Mapping{ of_device, {physical_button, InvalidIndex}, MappingType::ButtonToAxis, { to_pressed_value, 0 }, { and_released_value, 0 } });
+		MappingsChanged();
+	}
+
+	void IInputSystem::MapButtonToAxis2D(size_t physical_button, InputDeviceIndex of_device, vec2 to_pressed_value, Input of_input)
 	{
-		if (auto player = GetPlayer(input_id.Player))
+		mPlayers[of_input.Player].Mappings[of_input.ActionID].push_back(Mapping{ of_device, {physical_button, InvalidIndex}, MappingType::ButtonToAxis2D, to_pressed_value, { 0, 0 } });
+		MappingsChanged();
+	}
+
+	void IInputSystem::MapNavigation(UINavigationInput ui_input, Input to_input)
+	{
+		mPlayers[to_input.Player].Mappings[to_input.ActionID].push_back(Mapping{ InvalidIndex, {size_t(ui_input), InvalidIndex}, MappingType::Navigation });
+		MappingsChanged();
+	}
+
+	void IInputSystem::MapNavigation(size_t physical_input, InputDeviceIndex of_device, UINavigationInput to_ui_input, double press_threshold)
+	{
+		auto& bindings = mNavigationMappings[{ of_device, to_ui_input }];
+		if (physical_input != InvalidIndex)
 		{
-			if (auto it = player->Mappings.find(input_id.ActionID); it != player->Mappings.end())
+			const bool negative = press_threshold < 0;
+			bindings.push_back({ to_ui_input, physical_input, negative ? -1.0f : 1.0f, float(negative ? -press_threshold : press_threshold) });
+		}
+		RebuildNavigationTables();
+		MappingsChanged();
+	}
+
+	void IInputSystem::ResetNavigationMappings(InputDeviceIndex of_device)
+	{
+		std::erase_if(mNavigationMappings, [of_device](auto const& entry) { return entry.first.first == of_device; });
+		RebuildNavigationTables();
+		MappingsChanged();
+	}
+
+	void IInputSystem::SetAxisSmoothing(Input of_input, Seconds time_constant)
+	{
+		auto& player = mPlayers[of_input.Player];
+		player.AxisSmoothing[of_input.ActionID] = time_constant;
+		if (auto it = player.ResolvedActionIndices.find(of_input.ActionID); it != player.ResolvedActionIndices.end() && it->second < mResolvedActions.size())
+			mResolvedActions[it->second].SmoothingTime = time_constant.count();
+	}
+
+	void IInputSystem::CompileMappings()
+	{
+		mMappingSources.assign(1, MappingSource{});
+		mMappingRecords.clear();
+		mResolvedActions.clear();
+
+		std::map<std::tuple<InputDeviceIndex, size_t, bool>, uint32_t> source_indices;
+		const auto source_of = [&](MappingSource const& source) -> uint32_t {
+			if (source.Input == InvalidIndex)
+				return 0;
+			auto [it, added] = source_indices.try_emplace({ source.Device, source.Input, source.Gamepad != nullptr }, (uint32_t)mMappingSources.size());
+			if (added)
+				mMappingSources.push_back(source);
+			return it->second;
+		};
+
+		/// Navigation bindings on stick axes read the processed stick, so the stick deadzone applies to them
+		const auto navigation_source = [&](InputDeviceIndex device_index, size_t input) -> MappingSource {
+			if (auto gamepad = dynamic_cast<IGamepadDevice*>(InputDevice(device_index)))
 			{
-				for (auto& mapping : it->second)
+				for (uint8_t stick = 0; stick < gamepad->StickCount(); ++stick)
+				{
+					const auto stick_inputs = gamepad->StickAxisInputs(stick);
+					for (uint8_t axis = 0; axis < 2; ++axis)
+					{
+						if (stick_inputs[axis] == input)
+							return { device_index, input, gamepad, stick, axis };
+					}
+				}
+			}
+			return { device_index, input };
+		};
+		const auto navigation_record = [&](NavigationBinding const& binding, InputDeviceIndex device_index, uint32_t action) {
+			MappingRecord record{ MappingType::Navigation, action };
+			const auto device = InputDevice(device_index);
+			const auto props = device ? device->InputPropertiesOf(binding.Input) : nullptr;
+			const auto press = std::isnan(binding.PressThreshold) ? (props ? props->PressedThreshold : 0.5) : binding.PressThreshold;
+			record.Sources[0] = source_of(navigation_source(device_index, binding.Input));
+			record.Direction = binding.Direction < 0 ? -1.0f : 1.0f;
+			record.Matrix[0] = record.Direction;
+			record.PressThreshold = record.ReleaseThreshold = (float)press;
+			return record;
+		};
+
+		auto snapshot_keys = std::make_shared<std::vector<SnapshotActionKey>>();
+		for (auto& [player_id, player] : mPlayers)
+		{
+			player.ResolvedActionIndices.clear();
+			for (auto& [action_id, mappings] : player.Mappings)
+			{
+				const auto action_index = (uint32_t)mResolvedActions.size();
+				player.ResolvedActionIndices[action_id] = action_index;
+				snapshot_keys->push_back({ player_id, action_id });
+				auto& action = mResolvedActions.emplace_back();
+				if (auto it = player.AxisSmoothing.find(action_id); it != player.AxisSmoothing.end())
+					action.SmoothingTime = it->second.count();
+
+				for (auto& mapping : mappings)
 				{
-					if (auto device = InputDevice(mapping.DeviceID))
+					if (mapping.Type == MappingType::Navigation)
+					{
+						for (InputDeviceIndex device_index = 0; device_index < mNavigationTables.size(); ++device_index)
+						{
+							for (auto const& binding : mNavigationTables[device_index])
+							{
+								if (size_t(binding.Navigation) == mapping.Inputs[0] && binding.Input != InvalidIndex)
+									mMappingRecords.push_back(navigation_record(binding, device_index, action_index));
+							}
+						}
+						continue;
+					}
+
+					MappingRecord record{ mapping.Type, action_index };
+
+					auto device = InputDevice(mapping.DeviceID);
+					const auto props = device ? device->InputPropertiesOf(mapping.Inputs[0]) : nullptr;
+					const auto default_threshold = props ? props->PressedThreshold : 0.5;
+					auto press = std::isnan(mapping.PressThreshold) ? default_threshold : mapping.PressThreshold;
+					auto release = std::isnan(mapping.ReleaseThreshold) ? press : mapping.ReleaseThreshold;
+					if (press < 0)
+					{
+						record.Direction = -1;
+						press = -press;
+						release = -release;
+					}
+					record.PressThreshold = (float)press;
+					record.ReleaseThreshold = (float)std::min(press, release);
+
+					switch (mapping.Type)
 					{
-						if (device->IsInputPressed(mapping.Inputs[0]))
-							return true;
+					case MappingType::Button:
+					case MappingType::Axis1D:
+					case MappingType::AxisToButton:
+						record.Sources[0] = source_of({ mapping.DeviceID, mapping.Inputs[0] });
+						record.Matrix[0] = 1;
+						break;
+					case MappingType::Axis2D:
+					{
+						MappingSource x{ mapping.DeviceID, mapping.Inputs[0] }, y{ mapping.DeviceID, mapping.Inputs[1] };
+						if (auto gamepad = dynamic_cast<IGamepadDevice*>(device))
+						{
+							for (uint8_t stick = 0; stick < gamepad->StickCount(); ++stick)
+							{
+								const auto stick_inputs = gamepad->StickAxisInputs(stick);
+								if (stick_inputs[0] == mapping.Inputs[0] && stick_inputs[1] == mapping.Inputs[1])
+								{
+									x = { mapping.DeviceID, mapping.Inputs[0], gamepad, stick, 0 };
+									y = { mapping.DeviceID, mapping.Inputs[1], gamepad, stick, 1 };
+									break;
+								}
+							}
+						}
+						record.Sources[0] = source_of(x);
+						record.Sources[1] = source_of(y);
+						record.Matrix[0] = record.Matrix[3] = 1;
+						break;
+					}
+					case MappingType::ButtonToAxis:
+					case MappingType::ButtonToAxis2D:
+						record.Sources[0] = source_of({ mapping.DeviceID, mapping.Inputs[0] });
+						record.Offset[0] = (float)mapping.ReleasedValue.x;
+						record.Offset[1] = (float)mapping.ReleasedValue.y;
+						record.Matrix[0] = (float)(mapping.PressedValue.x - mapping.ReleasedValue.x);
+						record.Matrix[2] = (float)(mapping.PressedValue.y - mapping.ReleasedValue.y);
+						action.Normalize |= mapping.Type == MappingType::ButtonToAxis2D;
+						break;
+					case MappingType::Navigation:
+						break;
 					}
+
+					mMappingRecords.push_back(record);
 				}
 			}
 		}
+
+		mNavigationRecords.clear();
+		for (InputDeviceIndex device_index = 0; device_index < mNavigationTables.size(); ++device_index)
+		{
+			for (auto const& binding : mNavigationTables[device_index])
+			{
+				if (binding.Input != InvalidIndex)
+					mNavigationRecords.push_back(navigation_record(binding, device_index, uint32_t(binding.Navigation)));
+			}
+		}
+
+		mMappingSourceValues.assign(mMappingSources.size() * 2, 0.0f);
+
+		std::vector<bool> late_latched_actions(mResolvedActions.size(), false);
+		for (auto& [player_id, player] : mPlayers)
+		{
+			for (auto& action_id : player.LateLatchedActions)
+			{
+				if (auto it = player.ResolvedActionIndices.find(action_id); it != player.ResolvedActionIndices.end())
+					late_latched_actions[it->second] = true;
+			}
+		}
+		mLateLatchRecords.clear();
+		mLateLatchActions.clear();
+		mLateLatchSources.clear();
+		mLateLatchDevices.clear();
+		for (uint32_t action = 0; action < mResolvedActions.size(); ++action)
+		{
+			if (late_latched_actions[action])
+				mLateLatchActions.push_back(action);
+		}
+		for (uint32_t index = 0; index < mMappingRecords.size(); ++index)
+		{
+			auto& record = mMappingRecords[index];
+			if (!late_latched_actions[record.Action])
+				continue;
+			mLateLatchRecords.push_back(index);
+			for (auto source : record.Sources)
+			{
+				if (source == 0 || std::ranges::find(mLateLatchSources, source) != mLateLatchSources.end())
+					continue;
+				mLateLatchSources.push_back(source);
+				if (std::ranges::find(mLateLatchDevices, mMappingSources[source].Device) == mLateLatchDevices.end())
+					mLateLatchDevices.push_back(mMappingSources[source].Device);
+			}
+		}
+		mLateLatchChannels.clear();
+		mLateLatchStickSlots.clear();
+		for (auto source : mLateLatchSources)
+		{
+			auto const& mapping_source = mMappingSources[source];
+			if (mapping_source.Gamepad)
+			{
+				if (mapping_source.Gamepad->mFirstStickSlot != InvalidIndex)
+					mLateLatchStickSlots.push_back(uint32_t(mapping_source.Gamepad->mFirstStickSlot + mapping_source.Stick * 2));
+			}
+			else if (const auto channel = AnalogChannelOf(mapping_source.Device, mapping_source.Input); channel != InvalidIndex)
+				mLateLatchChannels.push_back(uint32_t(channel));
+		}
+		for (auto list : { &mLateLatchChannels, &mLateLatchStickSlots })
+		{
+			std::ranges::sort(*list);
+			list->erase(std::ranges::unique(*list).begin(), list->end());
+		}
+		mSnapshotActionKeys = std::move(snapshot_keys);
+
+		mMappingSourceOfInput.clear();
+		for (uint32_t source = 1; source < mMappingSources.size(); ++source)
+		{
+			if (!mMappingSources[source].Gamepad)
+				mMappingSourceOfInput[{ mMappingSources[source].Device, mMappingSources[source].Input }] = source;
+		}
+
+		mRecordsOfSourceOffsets.assign(mMappingSources.size() + 1, 0);
+		for (auto& record : mMappingRecords)
+			++mRecordsOfSourceOffsets[record.Sources[0] + 1];
+		for (size_t source = 0; source < mMappingSources.size(); ++source)
+			mRecordsOfSourceOffsets[source + 1] += mRecordsOfSourceOffsets[source];
+		mRecordsOfSource.resize(mMappingRecords.size());
+		auto fill = mRecordsOfSourceOffsets;
+		for (uint32_t index = 0; index < mMappingRecords.size(); ++index)
+			mRecordsOfSource[fill[mMappingRecords[index].Sources[0]]++] = index;
+
+		/// Tick state does not survive remapping; sampling restarts with the next tick
+		mTickChanges.clear();
+		mTickReportedValues.assign(mMappingSources.size(), 0.0f);
+		mTickSourceValues.assign(mMappingSources.size(), 0.0f);
+		mTickSourceAverages.assign(mMappingSources.size(), 0.0f);
+		mTickRecordStates.assign(mMappingRecords.size(), 0);
+		mTickActions = mResolvedActions;
+		mTickSampling = mTickActive = false;
+
+		mRepeats.Resize(mResolvedActions.size() + UINavigationInputCount);
+
+		mMappingsChanged = false;
+		++mMappingGeneration;
+		mMappingsStale = true;
+	}
+
+	void IInputSystem::GatherMappingSources()
+	{
+		const auto source_count = mMappingSources.size();
+		const auto current = mMappingSourceValues.data();
+		const auto last = current + source_count;
+		for (size_t i = 1; i < source_count; ++i)
+		{
+			current[i] = MappingSourceValue(mMappingSources[i], false);
+			last[i] = MappingSourceValue(mMappingSources[i], true);
+		}
+	}
+
+	auto IInputSystem::MappingSourceValue(MappingSource const& source, bool last_frame) -> float
+	{
+		if (source.Gamepad)
+			return (float)ProcessedStickValue(*source.Gamepad, source.Stick, last_frame)[source.Axis];
+		return (float)ProcessedInputValue(source.Device, source.Input, last_frame);
+	}
+
+	void IInputSystem::EvaluateMappingRecord(MappingRecord& record, ResolvedAction& action, float const* current, float const* last)
+	{
+		const auto x = current[record.Sources[0]];
+		const auto y = current[record.Sources[1]];
+		action.Value.x += record.Offset[0] + record.Matrix[0] * x + record.Matrix[1] * y;
+		action.Value.y += record.Offset[1] + record.Matrix[2] * x + record.Matrix[3] * y;
+
+		const auto directed = record.Direction * x;
+		const auto directed_last = record.Direction * last[record.Sources[0]];
+		const bool pressed_last = (directed_last >= record.PressThreshold) | (record.Latched & (directed_last > record.ReleaseThreshold));
+		const bool pressed = (directed >= record.PressThreshold) | (pressed_last & (directed > record.ReleaseThreshold));
+		record.Pressed = pressed;
+		action.Pressed |= pressed;
+		action.PressedLastFrame |= pressed_last;
+	}
+
+	void IInputSystem::FinishActions(std::span<ResolvedAction> actions, double dt, KeyRepeatScheduler* repeats, TimePoint now)
+	{
+		for (uint32_t index = 0; index < actions.size(); ++index)
+		{
+			auto& action = actions[index];
+			const auto length = std::sqrt(action.Value.x * action.Value.x + action.Value.y * action.Value.y);
+			if (action.Normalize && length > 1.0)
+				action.Value /= length;
+			const auto alpha = action.SmoothingTime > 0 ? 1.0 - std::exp(-dt / action.SmoothingTime) : 1.0;
+			action.SmoothedValue += (action.Value - action.SmoothedValue) * alpha;
+
+			/// Compared with the scheduler rather than the last frame, so edges in frames that were never resolved are not lost
+			if (repeats && action.Pressed != repeats->IsHeld(index))
+			{
+				if (action.Pressed)
+					repeats->Press(index, now);
+				else
+					repeats->Release(index);
+			}
+		}
+	}
+
+	void IInputSystem::ResolveMappings()
+	{
+		if (mMappingsChanged)
+			CompileMappings();
+
+		GatherMappingSources();
+		const auto current = mMappingSourceValues.data();
+		const auto last = current + mMappingSources.size();
+
+		/// Evaluate
+		for (auto& action : mResolvedActions)
+		{
+			action.Value = {};
+			action.Pressed = action.PressedLastFrame = false;
+		}
+
+		/// `Latched` is the state of the record at the end of the previous frame, for hysteresis;
+		/// resolving more than once in a frame must not advance it
+		const bool new_frame = mResolvedFrameNumber != mFrameNumber;
+		mResolvedFrameNumber = mFrameNumber;
+		for (auto& record : mMappingRecords)
+		{
+			record.Latched = new_frame ? record.Pressed : record.Latched;
+			EvaluateMappingRecord(record, mResolvedActions[record.Action], current, last);
+		}
+
+		/// Navigation records only contribute their pressed state, to one bit per navigation input
+		uint32_t navigation = 0, navigation_last = 0;
+		for (auto& record : mNavigationRecords)
+		{
+			record.Latched = new_frame ? record.Pressed : record.Latched;
+			ResolvedAction result;
+			EvaluateMappingRecord(record, result, current, last);
+			navigation |= uint32_t(result.Pressed) << record.Action;
+			navigation_last |= uint32_t(result.PressedLastFrame) << record.Action;
+		}
+		mNavigationPressed = navigation;
+		mNavigationPressedLastFrame = navigation_last;
+
+		/// Normalize and smooth
+		const auto now = std::chrono::high_resolution_clock::now();
+		const auto dt = mLastResolveTime == TimePoint{} ? 0.0 : Seconds{ now - mLastResolveTime }.count();
+		mLastResolveTime = now;
+		mLastResolveDeltaTime = dt;
+		FinishActions(mResolvedActions, dt, new_frame ? &mRepeats : nullptr, now);
+
+		if (new_frame)
+		{
+			UpdateNavigationRepeats(now);
+			mRepeats.Advance(now);
+		}
+
+		mMappingsStale = false;
+	}
+
+	void IInputSystem::UpdateNavigationRepeats(TimePoint now)
+	{
+		for (size_t input = 0; input < UINavigationInputCount; ++input)
+		{
+			const auto key = NavigationRepeatKey(UINavigationInput(input));
+			const bool pressed = ((mNavigationPressed | mInjectedNavigation) >> input) & 1;
+			if (pressed != mRepeats.IsHeld(key))
+			{
+				if (pressed)
+					mRepeats.Press(key, now);
+				else
+					mRepeats.Release(key);
+			}
+		}
+	}
+
+	void IInputSystem::PostOutput(InputDeviceIndex of_device, size_t output, OutputIntent const& intent)
+	{
+		if (const auto device = InputDevice(of_device))
+			mOutputs.Post(*device, output, intent);
+	}
+
+	void IInputSystem::UseSystemKeyRepeatSettings(ISystemDevice const& system)
+	{
+		if (system.IsSystemConfigValid(ISystemDevice::SystemConfig::KeyRepeatDelay))
+			mRepeats.Settings.Delay = Seconds{ system.SystemConfigValue(ISystemDevice::SystemConfig::KeyRepeatDelay).x };
+		if (system.IsSystemConfigValid(ISystemDevice::SystemConfig::KeyRepeatFrequency))
+		{
+			const auto frequency = system.SystemConfigValue(ISystemDevice::SystemConfig::KeyRepeatFrequency).x;
+			if (frequency > 0)
+				mRepeats.Settings.Interval = Seconds{ 1.0 / frequency };
+		}
+	}
+
+	void IInputSystem::SetLateLatched(Input action, bool late_latched)
+	{
+		auto& player = mPlayers[action.Player];
+		if (late_latched)
+			player.LateLatchedActions.insert(action.ActionID);
+		else if (auto it = player.LateLatchedActions.find(action.ActionID); it != player.LateLatchedActions.end())
+			player.LateLatchedActions.erase(it);
+		mMappingsChanged = true;
+	}
+
+	void IInputSystem::LateLatch()
+	{
+		const bool resolved = !mMappingsChanged && !mMappingsStale;
+
+		for (auto device_index : mLateLatchDevices)
+		{
+			if (auto device = InputDevice(device_index))
+				device->ForceRefresh();
+		}
+
+		/// Nothing queried the mappings this frame yet, so a regular resolve is as fresh as it gets
+		if (!resolved)
+		{
+			mAnalogInputsStale = true;
+			ResolveMappings();
+			return;
+		}
+
+		if (mLateLatchRecords.empty())
+			return;
+
+		if (mAnalogInputsStale)
+			ProcessAnalogInputs();
+		else
+			ProcessLateLatchedAnalogInputs();
+		const auto current = mMappingSourceValues.data();
+		const auto last = current + mMappingSources.size();
+		for (auto source : mLateLatchSources)
+			current[source] = MappingSourceValue(mMappingSources[source], false);
+
+		/// Redo the smoothing step of this frame with the new target: S = S' + (V - V') * alpha
+		const auto alpha_of = [dt = mLastResolveDeltaTime](ResolvedAction const& action) {
+			return action.SmoothingTime > 0 ? 1.0 - std::exp(-dt / action.SmoothingTime) : 1.0;
+		};
+		for (auto index : mLateLatchActions)
+		{
+			auto& action = mResolvedActions[index];
+			action.SmoothedValue -= action.Value * alpha_of(action);
+			action.Value = {};
+			action.Pressed = false;
+		}
+
+		for (auto index : mLateLatchRecords)
+		{
+			auto& record = mMappingRecords[index];
+			EvaluateMappingRecord(record, mResolvedActions[record.Action], current, last);
+		}
+
+		for (auto index : mLateLatchActions)
+		{
+			auto& action = mResolvedActions[index];
+			const auto length = std::sqrt(action.Value.x * action.Value.x + action.Value.y * action.Value.y);
+			if (action.Normalize && length > 1.0)
+				action.Value /= length;
+			const auto alpha = alpha_of(action);
+			action.SmoothedValue = alpha == 1.0 ? action.Value : action.SmoothedValue + action.Value * alpha;
+		}
+	}
+
+	void IInputSystem::ReportInputChange(InputDeviceIndex device, size_t input, double value, TimePoint timestamp)
+	{
+		if (!mTickSampling || mMappingsChanged || AnalogChannelOf(device, input) != InvalidIndex)
+			return;
+		if (auto it = mMappingSourceOfInput.find({ device, input }); it != mMappingSourceOfInput.end() && mTickReportedValues[it->second] != (float)value)
+		{
+			mTickReportedValues[it->second] = (float)value;
+			mTickChanges.push_back({ timestamp, it->second, (float)value });
+		}
+	}
+
+	void IInputSystem::SampleTickChanges(TimePoint timestamp)
+	{
+		GatherMappingSources();
+		for (uint32_t source = 1; source < mMappingSources.size(); ++source)
+		{
+			const auto value = mMappingSourceValues[source];
+			if (mTickReportedValues[source] != value)
+			{
+				mTickReportedValues[source] = value;
+				mTickChanges.push_back({ timestamp, source, value });
+			}
+		}
+	}
+
+	void IInputSystem::BeginTick(TimePoint tick_end)
+	{
+		if (mMappingsChanged)
+			CompileMappings();
+
+		if (!mTickSampling)
+		{
+			/// Sampling starts with the first tick
+			mTickSampling = true;
+			mTickStart = tick_end;
+			SampleTickChanges(tick_end);
+		}
+
+		const auto tick_length = std::max(Seconds{ tick_end - mTickStart }.count(), 0.0);
+		const auto source_count = mMappingSources.size();
+
+		/// Analog values are averaged over the tick: average = start value + sum(delta * time remaining after the change) / tick length
+		for (size_t source = 0; source < source_count; ++source)
+			mTickSourceAverages[source] = mTickSourceValues[source] * float(tick_length);
+
+		/// Edges are tracked per action as well, so a press (or release) of one of several inputs mapped to an action that 
+		/// stays pressed through another is not an edge of the action
+		mTickPressedRecords.assign(mTickActions.size(), 0);
+		for (size_t index = 0; index < mTickRecordStates.size(); ++index)
+		{
+			mTickRecordStates[index] &= TickRecordPressed;
+			mTickPressedRecords[mMappingRecords[index].Action] += mTickRecordStates[index];
+		}
+		for (auto& action : mTickActions)
+			action.TickEdges = 0;
+
+		/// Changes are replayed in order, so that every crossing of a press threshold becomes an edge in exactly one tick
+		std::ranges::stable_sort(mTickChanges, {}, &TickChange::Time);
+		const auto consumed = std::ranges::find_if(mTickChanges, [&](TickChange const& change) { return change.Time > tick_end; });
+		for (auto it = mTickChanges.begin(); it != consumed; ++it)
+		{
+			const auto delta = it->Value - mTickSourceValues[it->Source];
+			const auto remaining = std::clamp(Seconds{ tick_end - it->Time }.count(), 0.0, tick_length);
+			mTickSourceAverages[it->Source] += delta * float(remaining);
+			mTickSourceValues[it->Source] = it->Value;
+
+			for (auto index = mRecordsOfSourceOffsets[it->Source]; index < mRecordsOfSourceOffsets[it->Source + 1]; ++index)
+			{
+				auto& record = mMappingRecords[mRecordsOfSource[index]];
+				auto& state = mTickRecordStates[mRecordsOfSource[index]];
+				const auto directed = record.Direction * it->Value;
+				const bool was_pressed = state & TickRecordPressed;
+				const bool pressed = (directed >= record.PressThreshold) | (was_pressed & (directed > record.ReleaseThreshold));
+				state = uint8_t((state & ~TickRecordPressed) | (pressed ? TickRecordPressed : 0) | (pressed && !was_pressed ? TickRecordPressEdge : 0));
+				if (pressed == was_pressed)
+					continue;
+
+				auto& held = mTickPressedRecords[record.Action];
+				if (pressed ? held++ == 0 : --held == 0)
+					mTickActions[record.Action].TickEdges |= pressed ? TickRecordPressEdge : TickRecordReleaseEdge;
+			}
+		}
+		mTickChanges.erase(mTickChanges.begin(), consumed);
+
+		for (size_t source = 0; source < source_count; ++source)
+			mTickSourceAverages[source] = tick_length > 0 ? mTickSourceAverages[source] / float(tick_length) : mTickSourceValues[source];
+
+		/// Evaluate the records like `ResolveMappings` does, on the averaged values
+		for (auto& action : mTickActions)
+		{
+			action.PressedLastFrame = action.Pressed;
+			action.Value = {};
+			action.Pressed = false;
+		}
+		for (size_t index = 0; index < mMappingRecords.size(); ++index)
+		{
+			auto& record = mMappingRecords[index];
+			const auto x = mTickSourceAverages[record.Sources[0]];
+			const auto y = mTickSourceAverages[record.Sources[1]];
+			auto& action = mTickActions[record.Action];
+			action.Value.x += record.Offset[0] + record.Matrix[0] * x + record.Matrix[1] * y;
+			action.Value.y += record.Offset[1] + record.Matrix[2] * x + record.Matrix[3] * y;
+			/// A press and release within one tick still registers as pressed for that tick
+			action.Pressed |= (mTickRecordStates[index] & (TickRecordPressed | TickRecordPressEdge)) != 0;
+		}
+		FinishActions(mTickActions, tick_length);
+
+		mTickStart = tick_end;
+		mTickActive = true;
+	}
+
+	void IInputSystem::EndTick()
+	{
+		mTickActive = false;
+	}
+
+	/// State block layout: ActionStateHeader, ResolvedAction[ActionCount], uint8_t[RecordCount]
+	/// The record bytes are (pressed | latched << 1) for frame state, and the tick record state during a tick.
+	auto IInputSystem::ActionStateSize() -> size_t
+	{
+		if (mMappingsChanged || mMappingsStale)
+			ResolveMappings();
+		return sizeof(ActionStateHeader) + mResolvedActions.size() * sizeof(ResolvedAction) + mMappingRecords.size();
+	}
+
+	void IInputSystem::SnapshotActionState(std::span<std::byte> into)
+	{
+		const auto size = ActionStateSize();
+		if (into.size() < size)
+		{
+			ErrorReporter->NewWarning("Action state snapshot buffer too small")
+				.Value("BufferSize", into.size())
+				.Value("RequiredSize", size)
+				.Perform();
+			return;
+		}
+
+		auto& actions = mTickActive ? mTickActions : mResolvedActions;
+		const ActionStateHeader header{ mMappingGeneration, actions.size(), mMappingRecords.size() };
+		auto out = into.data();
+		std::memcpy(out, &header, sizeof(header));
+		out += sizeof(header);
+		std::memcpy(out, actions.data(), actions.size() * sizeof(ResolvedAction));
+		out += actions.size() * sizeof(ResolvedAction);
+		if (mTickActive)
+			std::memcpy(out, mTickRecordStates.data(), mTickRecordStates.size());
+		else
+		{
+			for (auto& record : mMappingRecords)
+				*out++ = std::byte(uint8_t(record.Pressed) | uint8_t(record.Latched << 1));
+		}
+	}
+
+	bool IInputSystem::RestoreActionState(std::span<std::byte const> from)
+	{
+		if (mMappingsChanged)
+			CompileMappings();
+
+		ActionStateHeader header;
+		if (from.size() < sizeof(header))
+			return false;
+		std::memcpy(&header, from.data(), sizeof(header));
+		if (header.MappingGeneration != mMappingGeneration || header.ActionCount != mResolvedActions.size() || header.RecordCount != mMappingRecords.size())
+			return false;
+		if (from.size() < sizeof(header) + header.ActionCount * sizeof(ResolvedAction) + header.RecordCount)
+			return false;
+
+		auto& actions = mTickActive ? mTickActions : mResolvedActions;
+		auto in = from.data() + sizeof(header);
+		std::memcpy(actions.data(), in, actions.size() * sizeof(ResolvedAction));
+		in += actions.size() * sizeof(ResolvedAction);
+		if (mTickActive)
+		{
+			std::memcpy(mTickRecordStates.data(), in, mTickRecordStates.size());
+			return true;
+		}
+		for (auto& record : mMappingRecords)
+		{
+			const auto bits = uint8_t(*in++);
+			record.Pressed = bits & 1;
+			record.Latched = (bits >> 1) & 1;
+		}
+
+		/// The restored state stands in for this frame's resolve
+		mMappingsStale = false;
+		mResolvedFrameNumber = mFrameNumber;
+		return true;
+	}
+
+	auto IInputSystem::ResolvedActionIndexOf(Input const& input) -> size_t
+	{
+		if (mMappingsChanged || mMappingsStale)
+			ResolveMappings();
+
+		if (auto player = GetPlayer(input.Player))
+		{
+			if (auto it = player->ResolvedActionIndices.find(input.ActionID); it != player->ResolvedActionIndices.end())
+				return it->second;
+		}
+		return InvalidIndex;
+	}
+
+	auto IInputSystem::ResolvedActionOf(Input const& input) -> ResolvedAction const*
+	{
+		const auto index = ResolvedActionIndexOf(input);
+		if (index == InvalidIndex)
+			return nullptr;
+		return mTickActive ? &mTickActions[index] : &mResolvedActions[index];
+	}
+
+	bool IInputSystem::IsButtonPressed(Input input_id)
+	{
+		if (auto action = ResolvedActionOf(input_id))
+			return action->Pressed;
 		return false;
 	}
 
@@ -68,20 +1028,9 @@ namespace libgameinput
 
 	bool IInputSystem::WasButtonPressed(Input input_id)
 	{
-		if (auto player = GetPlayer(input_id.Player))
-		{
-			if (auto it = player->Mappings.find(input_id.ActionID); it != player->Mappings.end())
-			{
-				for (auto& mapping : it->second)
-				{
-					if (auto device = InputDevice(mapping.DeviceID))
-					{
-						if (device->IsInputPressed(mapping.Inputs[0]) && !device->WasInputPressedLastFrame(mapping.Inputs[0]))
-							return true;
-					}
-				}
-			}
-		}
+		/// During a tick, a release and press within the tick is a press even though the action was pressed in the last tick too
+		if (auto action = ResolvedActionOf(input_id))
+			return mTickActive ? (action->TickEdges & TickRecordPressEdge) != 0 : action->Pressed && !action->PressedLastFrame;
 		return false;
 	}
 
@@ -97,20 +1046,8 @@ namespace libgameinput
 
 	bool IInputSystem::WasButtonReleased(Input input_id)
 	{
-		if (auto player = GetPlayer(input_id.Player))
-		{
-			if (auto it = player->Mappings.find(input_id.ActionID); it != player->Mappings.end())
-			{
-				for (auto& mapping : it->second)
-				{
-					if (auto device = InputDevice(mapping.DeviceID))
-					{
-						if (!device->IsInputPressed(mapping.Inputs[0]) && device->WasInputPressedLastFrame(mapping.Inputs[0]))
-							return true;
-					}
-				}
-			}
-		}
+		if (auto action = ResolvedActionOf(input_id))
+			return mTickActive ? (action->TickEdges & TickRecordReleaseEdge) != 0 : !action->Pressed && action->PressedLastFrame;
 		return false;
 	}
 
@@ -119,28 +1056,82 @@ namespace libgameinput
 		return !Keyboard()->IsInputPressed((size_t)key) && Keyboard()->WasInputPressedLastFrame((size_t)key);
 	}
 
+	int IInputSystem::ButtonRepeatCount(Input input_id)
+	{
+		const auto index = ResolvedActionIndexOf(input_id);
+		return index == InvalidIndex ? 0 : mRepeats.RepeatCount(uint32_t(index));
+	}
+
+	bool IInputSystem::WasButtonRepeated(Input input_id)
+	{
+		const auto index = ResolvedActionIndexOf(input_id);
+		return index != InvalidIndex && mRepeats.WasRepeated(uint32_t(index));
+	}
+
+	auto IInputSystem::NavigationPressedMask() -> uint32_t
+	{
+		if (mMappingsChanged || mMappingsStale)
+			ResolveMappings();
+		return mNavigationPressed | mInjectedNavigation;
+	}
+
+	auto IInputSystem::NavigationPressedLastFrameMask() -> uint32_t
+	{
+		if (mMappingsChanged || mMappingsStale)
+			ResolveMappings();
+		return mNavigationPressedLastFrame | mInjectedNavigationLastFrame;
+	}
+
+	bool IInputSystem::IsNavigationPressed(UINavigationInput input_id)
+	{
+		return (NavigationPressedMask() >> size_t(input_id)) & 1;
+	}
+
+	bool IInputSystem::WasNavigationPressed(UINavigationInput input_id)
+	{
+		const auto bit = 1u << size_t(input_id);
+		return (NavigationPressedMask() & bit) && !(NavigationPressedLastFrameMask() & bit);
+	}
+
+	bool IInputSystem::WasNavigationReleased(UINavigationInput input_id)
+	{
+		const auto bit = 1u << size_t(input_id);
+		return !(NavigationPressedMask() & bit) && (NavigationPressedLastFrameMask() & bit);
+	}
+
+	void IInputSystem::InjectInputChange(UINavigationInput input, bool value, bool include_in_recording)
+	{
+		/// TODO: Recording; `include_in_recording` is ignored until it exists
+		const auto bit = 1u << size_t(input);
+		mInjectedNavigation = value ? (mInjectedNavigation | bit) : (mInjectedNavigation & ~bit);
+	}
+
+	int IInputSystem::NavigationRepeatCount(UINavigationInput input_id)
+	{
+		if (mMappingsChanged || mMappingsStale)
+			ResolveMappings();
+		return mRepeats.RepeatCount(NavigationRepeatKey(input_id));
+	}
+
+	bool IInputSystem::WasNavigationRepeated(UINavigationInput input_id)
+	{
+		if (mMappingsChanged || mMappingsStale)
+			ResolveMappings();
+		return mRepeats.WasRepeated(NavigationRepeatKey(input_id));
+	}
+
 	float IInputSystem::AxisValue(Input of_input)
 	{
 		auto player = GetPlayer(of_input.Player);
 		if (!player)
 		{
-			ErrorReporter->NewWarning("Player not found for input")
-				.Value("PlayerID", of_input.Player.value)
-				.Value("ActionID", of_input.ActionID)
-				.Perform();
+			static ReportSite player_not_found{ ReportType::Warning, "Player not found for input" };
+			ErrorReporter->Report(player_not_found, "PlayerID", of_input.Player.value, "ActionID", of_input.ActionID);
 			return {};
 		}
 
-		if (auto it = player->Mappings.find(of_input.ActionID); it != player->Mappings.end())
-		{
-			for (auto& mapping : it->second)
-			{
-				if (auto device = InputDevice(mapping.DeviceID))
-				{
-					return (float)device->InputValue(mapping.Inputs[0]);
-				}
-			}
-		}
+		if (auto action = ResolvedActionOf(of_input))
+			return (float)action->SmoothedValue.x;
 		return 0.0f;
 	}
 
@@ -149,23 +1140,13 @@ namespace libgameinput
 		auto player = GetPlayer(of_input.Player);
 		if (!player)
 		{
-			ErrorReporter->NewWarning("Player not found for input")
-				.Value("PlayerID", of_input.Player.value)
-				.Value("ActionID", of_input.ActionID)
-				.Perform();
+			static ReportSite player_not_found{ ReportType::Warning, "Player not found for input" };
+			ErrorReporter->Report(player_not_found, "PlayerID", of_input.Player.value, "ActionID", of_input.ActionID);
 			return {};
 		}
 
-		if (auto it = player->Mappings.find(of_input.ActionID); it != player->Mappings.end())
-		{
-			for (auto& mapping : it->second)
-			{
-				if (auto device = InputDevice(mapping.DeviceID))
-				{
-					return { (float)device->InputValue(mapping.Inputs[0]), (float)device->InputValue(mapping.Inputs[1]) };
-				}
-			}
-		}
+		if (auto action = ResolvedActionOf(of_input))
+			return action->SmoothedValue;
 		return {};
 	}
 
@@ -174,7 +1155,7 @@ namespace libgameinput
 		return { (float)Mouse()->InputValue(Mouse()->XAxisInputID()), (float)Mouse()->InputValue(Mouse()->YAxisInputID()) };
 	}
 
-	IInputDevice* IInputSystem::InputDevice(InputDeviceIndex id)
+	IInputDevice* IInputSystem::InputDevice(InputDeviceIndex id) const
 	{
 		if (id < mInputDevices.size())
 			return mInputDevices[id].get();
@@ -197,12 +1178,66 @@ namespace libgameinput
 		return &player_it->second;
 	}
 
+	IInputSystem::PlayerInformation const* IInputSystem::GetPlayer(PlayerID id) const
+	{
+		auto player_it = mPlayers.find(id);
+		if (player_it == mPlayers.end())
+			return {};
+		return &player_it->second;
+	}
+
+	auto IInputSystem::LastActiveMapping(Input input) const -> std::pair<IInputDevice*, Mapping const*>
+	{
+		IInputDevice* last_device = nullptr;
+		Mapping const* last_mapping = nullptr;
+		TimePoint last_active = {};
+		if (auto player = GetPlayer(input.Player))
+		{
+			if (auto it = player->Mappings.find(input.ActionID); it != player->Mappings.end())
+			{
+				for (auto& mapping : it->second)
+				{
+					if (auto device = InputDevice(mapping.DeviceID); device && device->LastActiveTime() >= last_active)
+					{
+						last_mapping = &mapping;
+						last_device = device;
+						last_active = device->LastActiveTime();
+					}
+				}
+			}
+		}
+		return { last_device, last_mapping };
+	}
+
 	std::string IInputSystem::ButtonNamesForInput(Input button, std::string_view button_format)
 	{
 		std::string buttons;
-		for (auto& mapping : GetPlayer(button.Player)->Mappings[button.ActionID])
+		auto player = GetPlayer(button.Player);
+		if (!player)
+			return buttons;
+
+		auto it = player->Mappings.find(button.ActionID);
+		if (it == player->Mappings.end())
+			return buttons;
+
+		for (auto& mapping : it->second)
 		{
-			if (auto device = InputDevice(mapping.DeviceID))
+			if (mapping.Type == MappingType::Navigation)
+			{
+				for (InputDeviceIndex device_index = 0; device_index < mNavigationTables.size(); ++device_index)
+				{
+					for (auto const& binding : mNavigationTables[device_index])
+					{
+						const auto device = size_t(binding.Navigation) == mapping.Inputs[0] ? InputDevice(device_index) : nullptr;
+						const auto props = device ? device->InputPropertiesOf(binding.Input) : nullptr;
+						if (!props)
+							continue;
+						if (!buttons.empty()) buttons += ", ";
+						buttons += std::vformat(button_format, std::make_format_args(props->Name));
+					}
+				}
+			}
+			else if (auto device = InputDevice(mapping.DeviceID))
 			{
 				if (auto props = device->InputPropertiesOf(mapping.Inputs[0]))
 				{
@@ -222,27 +1257,64 @@ namespace libgameinput
 	std::string IInputSystem::ButtonNameForInput(Input input, std::string_view button_format)
 	{
 		/// Find the correct mapping from the device that was updated the latest
-
-		IInputDevice* last_device = nullptr;
-		Mapping* last_mapping = nullptr;
-		TimePoint last_active = {};
-		for (auto& mapping : GetPlayer(input.Player)->Mappings[input.ActionID])
+		if (auto [device, mapping] = LastActiveMapping(input); mapping)
 		{
-			if (auto device = InputDevice(mapping.DeviceID); device && device->LastActiveTime() >= last_active)
-			{
-				last_mapping = &mapping;
-				last_device = device;
-				last_active = device->LastActiveTime();
-			}
+			if (auto props = device->InputPropertiesOf(mapping->Inputs[0]))
+				return std::vformat(button_format, std::make_format_args(props->Name));
 		}
 
-		if (last_mapping)
+		return {};
+	}
+
+	std::string_view IInputSystem::CachedButtonNamesForInput(Input const& input, std::string_view button_format)
+	{
+		const PromptCacheKeyView key{ input.Player, input.ActionID, button_format };
+		if (auto it = mButtonNamesCache.find(key); it != mButtonNamesCache.end())
+			return it->second;
+		return mButtonNamesCache.emplace(PromptCacheKey{ input.Player, input.ActionID, std::string{ button_format } }, ButtonNamesForInput(input, button_format)).first->second;
+	}
+
+	std::string_view IInputSystem::CachedButtonNameForInput(Input const& input, std::string_view button_format)
+	{
+		const PromptCacheKeyView key{ input.Player, input.ActionID, button_format };
+		if (auto it = mButtonNameCache.find(key); it != mButtonNameCache.end())
+			return it->second;
+		return mButtonNameCache.emplace(PromptCacheKey{ input.Player, input.ActionID, std::string{ button_format } }, ButtonNameForInput(input, button_format)).first->second;
+	}
+
+	void IInputSystem::InvalidatePromptCache()
+	{
+		mButtonNamesCache.clear();
+		mButtonNameCache.clear();
+	}
+
+	std::string IInputSystem::CurrentGlyphForInput(Input input) const
+	{
+		if (auto [device, mapping] = LastActiveMapping(input); mapping)
 		{
-			if (auto props = last_device->InputPropertiesOf(last_mapping->Inputs[0]))
-				return std::vformat(button_format, std::make_format_args(props->Name));
+			if (auto props = device->InputPropertiesOf(mapping->Inputs[0]))
+				return std::string{ PrimaryGlyphURI(props->GlyphURIs) };
 		}
-
 		return {};
 	}
 
+	auto IInputSystem::CurrentGlyphRectForInput(Input input, GlyphAtlas const& atlas) const -> GlyphAtlasRect const*
+	{
+		if (auto [device, mapping] = LastActiveMapping(input); mapping)
+			return atlas.RectFor(*device, mapping->Inputs[0]);
+		return nullptr;
+	}
+
+	auto IInputSystem::CurrentGlyphRectForInput(Input input) const -> GlyphAtlasRect const*
+	{
+		return mGlyphAtlas ? CurrentGlyphRectForInput(std::move(input), *mGlyphAtlas) : nullptr;
+	}
+
+	void IInputSystem::SetGlyphAtlas(GlyphAtlas* atlas)
+	{
+		mGlyphAtlas = atlas;
+		if (mGlyphAtlas)
+			mGlyphAtlas->BindDevices(mInputDevices);
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "KeyRepeat.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace libgameinput
+{
+	/// Keeps a zero interval from repeating forever within one `Advance`
+	static constexpr Seconds ShortestInterval{ 0.001 };
+
+	auto KeyRepeatScheduler::TickOf(TimePoint time) -> int64_t
+	{
+		return (int64_t)std::floor(Seconds{ time.time_since_epoch() } / SlotDuration);
+	}
+
+	void KeyRepeatScheduler::Resize(size_t key_count)
+	{
+		mKeys.assign(key_count, KeyState{});
+		mSlots.fill(None);
+		mRepeated.clear();
+		mRepeated.reserve(std::min(key_count, size_t(64)));
+		mHeldCount = 0;
+	}
+
+	void KeyRepeatScheduler::Press(uint32_t key, TimePoint now)
+	{
+		if (key >= mKeys.size() || mKeys[key].Slot != None)
+			return;
+
+		if (!mStarted)
+		{
+			mTick = TickOf(now);
+			mStarted = true;
+		}
+
+		auto& state = mKeys[key];
+		state.Due = now + std::chrono::duration_cast<TimePoint::duration>(Settings.Delay);
+		state.Interval = std::max(Settings.Interval, ShortestInterval);
+		state.Count = 0;
+		Schedule(key);
+		++mHeldCount;
+	}
+
+	void KeyRepeatScheduler::Release(uint32_t key)
+	{
+		if (!IsHeld(key))
+			return;
+
+		Unlink(key);
+		mKeys[key].Count = 0;
+		--mHeldCount;
+	}
+
+	void KeyRepeatScheduler::Advance(TimePoint now)
+	{
+		++mGeneration;
+		mRepeated.clear();
+
+		const auto now_tick = TickOf(now);
+		if (!mStarted || mHeldCount == 0)
+		{
+			mTick = std::max(mTick, now_tick);
+			mStarted = true;
+			return;
+		}
+
+		/// After more than a revolution, every slot is visited once
+		const auto last_tick = std::min(now_tick, mTick + int64_t(WheelSlots) - 1);
+		for (auto tick = mTick; tick <= last_tick; ++tick)
+		{
+			for (auto key = mSlots[uint64_t(tick) % WheelSlots]; key != None; )
+			{
+				auto& state = mKeys[key];
+				const auto next = state.Next;
+				if (state.Due <= now)
+				{
+					while (state.Due <= now)
+					{
+						++state.Count;
+						state.Due += std::chrono::duration_cast<TimePoint::duration>(state.Interval);
+						if (Settings.Acceleration != 1.0 && Settings.Acceleration > 0)
+							state.Interval = std::max(Seconds{ state.Interval.count() / Settings.Acceleration }, std::max(Settings.MinInterval, ShortestInterval));
+					}
+					state.RepeatedIn = mGeneration;
+					mRepeated.push_back(key);
+
+					/// Relinked at the head of a slot, so it is not visited again in this walk unless due again, which it is not
+					Unlink(key);
+					Schedule(key);
+				}
+				key = next;
+			}
+		}
+		mTick = std::max(mTick, now_tick);
+	}
+
+	void KeyRepeatScheduler::Schedule(uint32_t key)
+	{
+		auto& state = mKeys[key];
+		const auto slot = uint32_t(uint64_t(std::max(TickOf(state.Due), mTick)) % WheelSlots);
+		state.Slot = slot;
+		state.Prev = None;
+		state.Next = mSlots[slot];
+		if (state.Next != None)
+			mKeys[state.Next].Prev = key;
+		mSlots[slot] = key;
+	}
+
+	void KeyRepeatScheduler::Unlink(uint32_t key)
+	{
+		auto& state = mKeys[key];
+		if (state.Prev != None)
+			mKeys[state.Prev].Next = state.Next;
+		else
+			mSlots[state.Slot] = state.Next;
+		if (state.Next != None)
+			mKeys[state.Next].Prev = state.Prev;
+		state.Slot = state.Next = state.Prev = None;
+	}
+}
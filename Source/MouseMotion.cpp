@@ -0,0 +1,41 @@
+#include "MouseMotion.h"
+
+namespace libgameinput
+{
+	void MouseMotionAccumulator::AddMotion(vec2 delta, TimePoint time)
+	{
+		++mEventCount;
+		if (delta.x == 0 && delta.y == 0)
+			return;
+
+		mTotal += delta;
+
+		if (mPathSize > 0 && time - mSampleStart < mResolution)
+		{
+			auto& sample = mPath[mPathSize - 1];
+			sample.Delta += delta;
+			sample.Time = time;
+			return;
+		}
+
+		if (mPathSize == MaxPathSamples)
+		{
+			for (size_t i = 0; i < MaxPathSamples / 2; ++i)
+				mPath[i] = { mPath[i * 2 + 1].Time, mPath[i * 2].Delta + mPath[i * 2 + 1].Delta };
+			mPathSize = MaxPathSamples / 2;
+			mResolution *= 2;
+		}
+
+		mPath[mPathSize++] = { time, delta };
+		mSampleStart = time;
+	}
+
+	void MouseMotionAccumulator::NewFrame()
+	{
+		mLastFrameTotal = mTotal;
+		mTotal = {};
+		mPathSize = 0;
+		mResolution = PathResolution;
+		mEventCount = 0;
+	}
+}
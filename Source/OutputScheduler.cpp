@@ -0,0 +1,178 @@
+#include "OutputScheduler.h"
+#include "InputDevice.h"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+
+namespace libgameinput
+{
+	static auto OutputKey(IInputDevice const* device, size_t output)
+	{
+		return std::pair{ uintptr_t(device), output };
+	}
+
+	void OutputScheduler::Post(IInputDevice& device, size_t output, OutputIntent const& intent)
+	{
+		if (!device.OutputPropertiesOf(output))
+			return;
+
+		if (intent.Source != 0)
+		{
+			const auto existing = std::ranges::find_if(mIntents, [&](Intent const& other) {
+				return other.Request.Source == intent.Source && other.Device == &device && other.Output == output;
+			});
+			if (existing != mIntents.end())
+			{
+				*existing = { &device, output, intent, {}, ++mSequence };
+				return;
+			}
+		}
+		mIntents.push_back({ &device, output, intent, {}, ++mSequence });
+	}
+
+	void OutputScheduler::Cancel(uint32_t source)
+	{
+		if (source != 0)
+			std::erase_if(mIntents, [&](Intent const& intent) { return intent.Request.Source == source; });
+	}
+
+	void OutputScheduler::CancelAll()
+	{
+		mIntents.clear();
+	}
+
+	void OutputScheduler::RemoveDevice(IInputDevice const* device)
+	{
+		std::erase_if(mIntents, [&](Intent const& intent) { return intent.Device == device; });
+		std::erase_if(mStates, [&](OutputState const& state) { return state.Device == device; });
+	}
+
+	void OutputScheduler::RemoveDevicesExcept(std::span<std::unique_ptr<IInputDevice> const> devices)
+	{
+		const auto removed = [&](IInputDevice const* device) {
+			return std::ranges::none_of(devices, [&](auto const& present) { return present.get() == device; });
+		};
+		std::erase_if(mIntents, [&](Intent const& intent) { return removed(intent.Device); });
+		std::erase_if(mStates, [&](OutputState const& state) { return removed(state.Device); });
+	}
+
+	auto OutputScheduler::StateOf(IInputDevice* device, size_t output) -> OutputState&
+	{
+		const auto key = OutputKey(device, output);
+		auto it = std::ranges::lower_bound(mStates, key, {}, [](OutputState const& state) { return OutputKey(state.Device, state.Output); });
+		if (it == mStates.end() || it->Device != device || it->Output != output)
+			it = mStates.insert(it, OutputState{ device, output });
+		return *it;
+	}
+
+	auto OutputScheduler::WrittenValue(IInputDevice const* device, size_t output) const -> vec3 const*
+	{
+		const auto key = OutputKey(device, output);
+		const auto it = std::ranges::lower_bound(mStates, key, {}, [](OutputState const& state) { return OutputKey(state.Device, state.Output); });
+		return it != mStates.end() && it->Device == device && it->Output == output && it->Written ? &it->Value : nullptr;
+	}
+
+	auto OutputScheduler::Merge(std::span<Intent const> intents) -> vec3
+	{
+		auto value = intents.front().Request.Value;
+		for (auto const& intent : intents.subspan(1))
+		{
+			auto const& other = intent.Request.Value;
+			switch (intent.Request.Blend)
+			{
+			case OutputBlend::Replace: value = other; break;
+			case OutputBlend::Max: value = glm::max(value, other); break;
+			case OutputBlend::Add: value += other; break;
+			case OutputBlend::Multiply: value *= other; break;
+			}
+		}
+		return value;
+	}
+
+	void OutputScheduler::Flush(TimePoint now)
+	{
+		std::erase_if(mIntents, [&](Intent const& intent) { return intent.Expires != TimePoint{} && intent.Expires <= now; });
+		for (auto& intent : mIntents)
+		{
+			if (intent.Request.Duration > Seconds{ 0 } && intent.Expires == TimePoint{})
+				intent.Expires = now + std::chrono::duration_cast<TimePoint::duration>(intent.Request.Duration);
+		}
+
+		/// Grouped by output, highest priority first, in the order they were posted
+		std::ranges::sort(mIntents, [](Intent const& a, Intent const& b) {
+			return std::tuple{ OutputKey(a.Device, a.Output), -int64_t(a.Request.Priority), a.Sequence }
+				< std::tuple{ OutputKey(b.Device, b.Output), -int64_t(b.Request.Priority), b.Sequence };
+		});
+
+		mWrites.clear();
+		for (auto& state : mStates)
+			state.Wanted = false;
+
+		for (size_t first = 0; first < mIntents.size(); )
+		{
+			auto const& head = mIntents[first];
+			auto last = first + 1;
+			while (last < mIntents.size() && mIntents[last].Device == head.Device && mIntents[last].Output == head.Output)
+				++last;
+			auto top = first + 1;
+			while (top < last && mIntents[top].Request.Priority == head.Request.Priority)
+				++top;
+
+			auto value = Merge(std::span{ mIntents }.subspan(first, top - first));
+			if (const auto props = head.Device->OutputPropertiesOf(head.Output))
+			{
+				switch (props->Type)
+				{
+				case InputDeviceOutputType::Flag:
+					value = glm::step(vec3{ 0.5 }, value);
+					break;
+				case InputDeviceOutputType::Vibration:
+				case InputDeviceOutputType::Color:
+					value = glm::clamp(value, 0.0, 1.0);
+					break;
+				default:
+					break;
+				}
+			}
+
+			auto& state = StateOf(head.Device, head.Output);
+			state.Wanted = true;
+			const auto change = glm::abs(value - state.Value);
+			if (!state.Written || std::max({ change.x, change.y, change.z }) > Tolerance)
+			{
+				mWrites.push_back({ head.Device, head.Output, value });
+				state.Value = value;
+				state.Written = true;
+			}
+			first = last;
+		}
+
+		for (auto const& state : mStates)
+		{
+			if (!state.Wanted && state.Written)
+				mWrites.push_back({ state.Device, state.Output, {}, true });
+		}
+		std::erase_if(mStates, [](OutputState const& state) { return !state.Wanted; });
+
+		/// Intents and states were both visited in device order, but the resets came after the writes
+		std::ranges::stable_sort(mWrites, {}, [](Write const& write) { return uintptr_t(write.Device); });
+		for (size_t first = 0; first < mWrites.size(); )
+		{
+			const auto device = mWrites[first].Device;
+			device->BeginOutputBatch();
+			for (; first < mWrites.size() && mWrites[first].Device == device; ++first)
+			{
+				auto const& write = mWrites[first];
+				if (write.Reset)
+					device->ResetOutput(write.Output);
+				else
+					device->SetOutput(write.Output, write.Value);
+			}
+			device->EndOutputBatch();
+		}
+		mWritesLastFlush = mWrites.size();
+
+		std::erase_if(mIntents, [](Intent const& intent) { return intent.Request.Duration <= Seconds{ 0 }; });
+	}
+}
@@ -0,0 +1,110 @@
+#include "PoseHistory.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+
+namespace libgameinput
+{
+	void PoseHistory::Record(Pose const& pose)
+	{
+		const auto sample = mCount.load(std::memory_order_relaxed);
+		const auto time = pose.Time.time_since_epoch().count();
+		if (sample > mFirst.load(std::memory_order_relaxed) && time <= mSlots[(sample - 1) % Capacity].Time.load(std::memory_order_relaxed))
+			return;
+
+		auto& slot = mSlots[sample % Capacity];
+		slot.Version.store(sample * 2 + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		slot.Time.store(time, std::memory_order_relaxed);
+		const double values[7] = { pose.Position.x, pose.Position.y, pose.Position.z, pose.Rotation.w, pose.Rotation.x, pose.Rotation.y, pose.Rotation.z };
+		for (size_t i = 0; i < 7; ++i)
+			slot.Values[i].store(values[i], std::memory_order_relaxed);
+
+		slot.Version.store(sample * 2 + 2, std::memory_order_release);
+		mCount.store(sample + 1, std::memory_order_release);
+	}
+
+	void PoseHistory::Clear()
+	{
+		mFirst.store(mCount.load(std::memory_order_relaxed), std::memory_order_release);
+	}
+
+	bool PoseHistory::ReadSample(uint64_t sample, Pose& into) const
+	{
+		auto& slot = mSlots[sample % Capacity];
+		const auto version = slot.Version.load(std::memory_order_acquire);
+		if (version != sample * 2 + 2)
+			return false;
+
+		const auto time = slot.Time.load(std::memory_order_relaxed);
+		double values[7];
+		for (size_t i = 0; i < 7; ++i)
+			values[i] = slot.Values[i].load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.Version.load(std::memory_order_relaxed) != version)
+			return false;
+
+		into.Time = TimePoint{ TimePoint::duration{ time } };
+		into.Position = { values[0], values[1], values[2] };
+		into.Rotation = quat{ values[3], values[4], values[5], values[6] };
+		return true;
+	}
+
+	auto PoseHistory::OldestReadableSample(uint64_t count) const -> uint64_t
+	{
+		/// The slot after the newest one may be being overwritten right now
+		const auto first = mFirst.load(std::memory_order_acquire);
+		return std::max(first, count >= Capacity ? count - Capacity + 1 : 0);
+	}
+
+	auto PoseHistory::Newest() const -> std::optional<Pose>
+	{
+		const auto count = mCount.load(std::memory_order_acquire);
+		Pose result;
+		if (count > OldestReadableSample(count) && ReadSample(count - 1, result))
+			return result;
+		return std::nullopt;
+	}
+
+	auto PoseHistory::At(TimePoint time) const -> std::optional<Pose>
+	{
+		const auto count = mCount.load(std::memory_order_acquire);
+		const auto oldest = OldestReadableSample(count);
+		if (count <= oldest)
+			return std::nullopt;
+
+		Pose later;
+		if (!ReadSample(count - 1, later))
+			return std::nullopt;
+
+		const auto blend = [time](Pose const& a, Pose const& b, double alpha) {
+			return Pose{ time, a.Position + (b.Position - a.Position) * alpha, glm::normalize(glm::slerp(a.Rotation, b.Rotation, alpha)) };
+		};
+
+		if (time >= later.Time)
+		{
+			Pose earlier;
+			if (count - 1 <= oldest || !ReadSample(count - 2, earlier) || earlier.Time >= later.Time)
+				return Pose{ time, later.Position, later.Rotation };
+
+			const auto ahead = std::min(Seconds{ time - later.Time }, MaxExtrapolation);
+			return blend(earlier, later, 1.0 + ahead / Seconds{ later.Time - earlier.Time });
+		}
+
+		/// Trackers are usually queried close to the newest sample, so search from there
+		for (auto sample = count - 1; sample-- > oldest; )
+		{
+			Pose earlier;
+			if (!ReadSample(sample, earlier))
+				break;
+			if (earlier.Time <= time)
+				return blend(earlier, later, Seconds{ time - earlier.Time } / Seconds{ later.Time - earlier.Time });
+			later = earlier;
+		}
+
+		return later;
+	}
+}
@@ -0,0 +1,336 @@
+#include "InputDevice.h"
+#include "GestureRecognizer.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <bit>
+
+namespace libgameinput
+{
+	namespace
+	{
+		struct TouchAxisInputProperties : InputProperties
+		{
+			TouchAxisInputProperties(std::string_view name, double min, double max)
+			{
+				Name = name;
+				Flags.unset(InputFlags::Digital);
+				DeadZoneMin = DeadZoneMax = 0;
+				MinValue = min;
+				MaxValue = max;
+			}
+		};
+
+		struct VirtualStickAxisInputProperties : InputProperties
+		{
+			VirtualStickAxisInputProperties(std::string_view name)
+			{
+				Name = name;
+				Flags.unset(InputFlags::Digital);
+				Flags.set(InputFlags::ReturnsToNeutral);
+				Flags.set(InputFlags::HasDeadzone);
+				Flags.set(InputFlags::Emulated);
+			}
+		};
+	}
+
+	auto ITouchDevice::BaseInputProperties() -> std::vector<InputProperties>
+	{
+		auto contact_count = TouchAxisInputProperties{ "Contact Count", 0, double(MaxContacts) };
+		contact_count.Flags.set(InputFlags::ReturnsToNeutral);
+		contact_count.StepSize = 1;
+		auto pressure = TouchAxisInputProperties{ "Primary Contact Pressure", 0, 1 };
+		pressure.Flags.set(InputFlags::ReturnsToNeutral);
+
+		return {
+			ButtonInputProperties{ "Touch", "ControllerGraphics/Gestures/Gesture_Finger_Front.png" },
+			contact_count,
+			TouchAxisInputProperties{ "Primary Contact X", 0, std::numeric_limits<double>::max() },
+			TouchAxisInputProperties{ "Primary Contact Y", 0, std::numeric_limits<double>::max() },
+			pressure,
+		};
+	}
+
+	auto ITouchDevice::Contact(size_t id) const -> TouchContact const*
+	{
+		for (auto const& contact : Contacts())
+			if (contact.ID == id)
+				return &contact;
+		return nullptr;
+	}
+
+	auto ITouchDevice::AddVirtualButton(std::string name, rec2 area, std::string glyph_uri) -> size_t
+	{
+		if (mControls.size() == MaxVirtualControls)
+			return InvalidIndex;
+
+		const auto first_input = mInputProperties.size();
+		mControls.push_back({ area, first_input });
+		mInputProperties.push_back(ButtonInputProperties{ name, std::move(glyph_uri) });
+		mValues.resize(mInputProperties.size());
+		mLastValues.resize(mInputProperties.size());
+		mValuesStale = true;
+		RebuildHitGrid();
+		return first_input;
+	}
+
+	auto ITouchDevice::AddVirtualStick(std::string name, rec2 area, double radius, bool floating) -> size_t
+	{
+		if (mControls.size() == MaxVirtualControls || radius <= 0)
+			return InvalidIndex;
+
+		const auto first_input = mInputProperties.size();
+		mControls.push_back({ area, first_input, radius, floating });
+		mInputProperties.push_back(VirtualStickAxisInputProperties{ name + " X Axis" });
+		mInputProperties.push_back(VirtualStickAxisInputProperties{ name + " Y Axis" });
+		mValues.resize(mInputProperties.size());
+		mLastValues.resize(mInputProperties.size());
+		mValuesStale = true;
+		RebuildHitGrid();
+		return first_input;
+	}
+
+	void ITouchDevice::ClearVirtualControls()
+	{
+		mControls.clear();
+		mInputProperties.resize(size_t(TouchInput::FirstVirtualControl));
+		mValues.resize(mInputProperties.size());
+		mLastValues.resize(mInputProperties.size());
+		for (auto& contact : mFrame.Contacts)
+			contact.Control = InvalidIndex;
+		mValuesStale = true;
+		RebuildHitGrid();
+	}
+
+	void ITouchDevice::RebuildHitGrid()
+	{
+		mHitGrid.fill(0);
+		if (mControls.empty())
+			return;
+
+		mHitGridBounds = mControls[0].Area;
+		for (auto const& control : mControls)
+		{
+			mHitGridBounds.p1 = { std::min(mHitGridBounds.p1.x, control.Area.p1.x), std::min(mHitGridBounds.p1.y, control.Area.p1.y) };
+			mHitGridBounds.p2 = { std::max(mHitGridBounds.p2.x, control.Area.p2.x), std::max(mHitGridBounds.p2.y, control.Area.p2.y) };
+		}
+
+		const auto cell_size = mHitGridBounds.size() / double(HitGridSize);
+		const auto cell_of = [&](double value, double origin, double size) {
+			return size > 0 ? std::clamp(size_t(std::max((value - origin) / size, 0.0)), size_t{}, HitGridSize - 1) : size_t{};
+		};
+		for (size_t i = 0; i < mControls.size(); ++i)
+		{
+			auto const& area = mControls[i].Area;
+			const auto x1 = cell_of(area.p1.x, mHitGridBounds.p1.x, cell_size.x), x2 = cell_of(area.p2.x, mHitGridBounds.p1.x, cell_size.x);
+			const auto y1 = cell_of(area.p1.y, mHitGridBounds.p1.y, cell_size.y), y2 = cell_of(area.p2.y, mHitGridBounds.p1.y, cell_size.y);
+			for (auto y = y1; y <= y2; ++y)
+				for (auto x = x1; x <= x2; ++x)
+					mHitGrid[y * HitGridSize + x] |= uint64_t{ 1 } << i;
+		}
+	}
+
+	auto ITouchDevice::VirtualControlAt(vec2 point) const -> size_t
+	{
+		if (mControls.empty() || !mHitGridBounds.contains(point))
+			return InvalidIndex;
+
+		/// Degenerate bounds put every control in cell 0 (see `RebuildHitGrid`)
+		const auto size = mHitGridBounds.size();
+		const auto cell_of = [](double value, double origin, double size) {
+			return size > 0 ? std::min(size_t((value - origin) / size * HitGridSize), HitGridSize - 1) : size_t{};
+		};
+		const auto x = cell_of(point.x, mHitGridBounds.p1.x, size.x);
+		const auto y = cell_of(point.y, mHitGridBounds.p1.y, size.y);
+
+		/// Topmost first
+		for (auto candidates = mHitGrid[y * HitGridSize + x]; candidates; )
+		{
+			const auto index = size_t(std::bit_width(candidates) - 1);
+			if (mControls[index].Area.contains(point))
+				return index;
+			candidates &= ~(uint64_t{ 1 } << index);
+		}
+		return InvalidIndex;
+	}
+
+	bool ITouchDevice::AddContactEvent(std::array<TouchContact, MaxContactEventsPerFrame>& list, size_t& count, TouchContact const& contact)
+	{
+		if (count == list.size())
+		{
+			++mFrame.DroppedEvents;
+			return false;
+		}
+		list[count++] = contact;
+		return true;
+	}
+
+	auto ITouchDevice::FindContact(size_t os_contact) const -> size_t
+	{
+		for (size_t i = 0; i < mFrame.ContactCount; ++i)
+			if (mFrame.OSContacts[i] == os_contact)
+				return i;
+		return InvalidIndex;
+	}
+
+	void ITouchDevice::ContactBegan(size_t os_contact, vec2 position, TimePoint time, double pressure, vec2 size)
+	{
+		/// A missed end event; the OS has already reused the id
+		if (const auto existing = FindContact(os_contact); existing != InvalidIndex)
+			RemoveContact(existing, time, true);
+
+		if (mFrame.ContactCount == MaxContacts)
+		{
+			++mFrame.DroppedEvents;
+			return;
+		}
+
+		const auto index = mFrame.ContactCount++;
+		auto& contact = mFrame.Contacts[index];
+		contact = { mNextContactID++, position, position, position, pressure, size, time, time, VirtualControlAt(position) };
+		mFrame.OSContacts[index] = os_contact;
+		mFrame.MovedEntries[index] = InvalidIndex;
+		AddContactEvent(mFrame.Began, mFrame.BeganCount, contact);
+		mValuesStale = true;
+
+		if (mGestures && contact.Control == InvalidIndex)
+			mGestures->PointerDown(contact.ID, position, time);
+	}
+
+	void ITouchDevice::ContactMoved(size_t os_contact, vec2 position, TimePoint time, double pressure, vec2 size)
+	{
+		const auto index = FindContact(os_contact);
+		if (index == InvalidIndex)
+			return;
+
+		auto& contact = mFrame.Contacts[index];
+		contact.Position = position;
+		contact.Pressure = pressure;
+		contact.Size = size;
+		contact.LastChangeTime = time;
+		mValuesStale = true;
+
+		/// One entry per contact per frame, updated in place
+		if (auto& entry = mFrame.MovedEntries[index]; entry != InvalidIndex)
+			mFrame.Moved[entry] = contact;
+		else if (AddContactEvent(mFrame.Moved, mFrame.MovedCount, contact))
+			entry = mFrame.MovedCount - 1;
+
+		if (mGestures && contact.Control == InvalidIndex)
+			mGestures->PointerMoved(contact.ID, position, time);
+	}
+
+	void ITouchDevice::ContactEnded(size_t os_contact, vec2 position, TimePoint time)
+	{
+		const auto index = FindContact(os_contact);
+		if (index == InvalidIndex)
+			return;
+
+		auto& contact = mFrame.Contacts[index];
+		contact.Position = position;
+		contact.LastChangeTime = time;
+		RemoveContact(index, time, false);
+	}
+
+	void ITouchDevice::ContactCancelled(size_t os_contact, TimePoint time)
+	{
+		if (const auto index = FindContact(os_contact); index != InvalidIndex)
+			RemoveContact(index, time, true);
+	}
+
+	void ITouchDevice::CancelAllContacts(TimePoint time)
+	{
+		while (mFrame.ContactCount)
+			RemoveContact(mFrame.ContactCount - 1, time, true);
+	}
+
+	void ITouchDevice::RemoveContact(size_t index, TimePoint time, bool cancelled)
+	{
+		auto const& contact = mFrame.Contacts[index];
+		AddContactEvent(mFrame.Ended, mFrame.EndedCount, contact);
+
+		if (mGestures && contact.Control == InvalidIndex)
+		{
+			if (cancelled)
+				mGestures->PointerCancelled(contact.ID);
+			else
+				mGestures->PointerUp(contact.ID, contact.Position, time);
+		}
+
+		/// Shift rather than swap, to keep the contacts oldest first
+		const auto count = mFrame.ContactCount;
+		std::move(mFrame.Contacts.begin() + index + 1, mFrame.Contacts.begin() + count, mFrame.Contacts.begin() + index);
+		std::move(mFrame.OSContacts.begin() + index + 1, mFrame.OSContacts.begin() + count, mFrame.OSContacts.begin() + index);
+		std::move(mFrame.MovedEntries.begin() + index + 1, mFrame.MovedEntries.begin() + count, mFrame.MovedEntries.begin() + index);
+		--mFrame.ContactCount;
+		mValuesStale = true;
+	}
+
+	void ITouchDevice::NewFrame()
+	{
+		RefreshValues();
+		std::ranges::copy(mValues, mLastValues.begin());
+
+		for (size_t i = 0; i < mFrame.ContactCount; ++i)
+		{
+			mFrame.Contacts[i].LastFramePosition = mFrame.Contacts[i].Position;
+			mFrame.MovedEntries[i] = InvalidIndex;
+		}
+		mFrame.BeganCount = mFrame.MovedCount = mFrame.EndedCount = mFrame.DroppedEvents = 0;
+		mFirstContactOfFrame = mNextContactID;
+		mValuesStale = true;
+	}
+
+	double ITouchDevice::InputValue(size_t input) const
+	{
+		RefreshValues();
+		return input < mValues.size() ? mValues[input] : 0.0;
+	}
+
+	void ITouchDevice::RefreshValues() const
+	{
+		if (!mValuesStale)
+			return;
+		mValuesStale = false;
+
+		mValues[size_t(TouchInput::AnyContact)] = mFrame.ContactCount > 0;
+		mValues[size_t(TouchInput::ContactCount)] = double(mFrame.ContactCount);
+		/// Like the mouse position, the primary position stays where it was last
+		if (auto primary = PrimaryContact())
+		{
+			mValues[size_t(TouchInput::PrimaryX)] = primary->Position.x;
+			mValues[size_t(TouchInput::PrimaryY)] = primary->Position.y;
+			mValues[size_t(TouchInput::PrimaryPressure)] = primary->Pressure;
+		}
+		else
+			mValues[size_t(TouchInput::PrimaryPressure)] = 0;
+
+		std::fill(mValues.begin() + size_t(TouchInput::FirstVirtualControl), mValues.end(), 0.0);
+		for (auto const& contact : Contacts())
+		{
+			if (contact.Control >= mControls.size())
+				continue;
+
+			auto const& control = mControls[contact.Control];
+			if (control.Radius == 0)
+			{
+				mValues[control.FirstInput] = 1.0;
+				continue;
+			}
+
+			const auto center = control.Floating ? contact.StartPosition : control.Area.center();
+			auto offset = (contact.Position - center) / control.Radius;
+			if (const auto length = glm::length(offset); length > 1)
+				offset /= length;
+			mValues[control.FirstInput] = offset.x;
+			mValues[control.FirstInput + 1] = offset.y;
+		}
+		/// A tap on a screen button that began and ended within the frame still presses it for the frame
+		for (auto const& contact : EndedContacts())
+		{
+			if (contact.ID >= mFirstContactOfFrame && contact.Control < mControls.size() && mControls[contact.Control].Radius == 0)
+				mValues[mControls[contact.Control].FirstInput] = 1.0;
+		}
+	}
+}
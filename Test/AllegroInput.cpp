@@ -50,13 +50,6 @@ namespace libgameinput
 		return LastFrameState[input].Down;
 	}
 
-	std::optional<InputProperties> AllegroKeyboard::PropertiesOf(DeviceInputID input) const
-	{
-		if (!IsInputValid(input))
-			return {};
-		return ButtonInputProperties{ magic_enum::enum_name((KeyboardButton)input) };
-	}
-
 	void AllegroKeyboard::ForceRefresh()
 	{
 		ALLEGRO_KEYBOARD_STATE state;
@@ -126,6 +119,10 @@ namespace libgameinput
 	{
 		if (!IsInputValid(input))
 			return 0.0;
+		if (input == XDelta || input == YDelta)
+			return mMotion.Total()[int(input - XDelta)];
+		if (input >= FirstClickCount)
+			return ClickCount(MouseButton(input - FirstClickCount));
 		return CurrentState[input];
 	}
 
@@ -140,6 +137,10 @@ namespace libgameinput
 	{
 		if (!IsInputValid(input))
 			return 0.0;
+		if (input == XDelta || input == YDelta)
+			return mMotion.LastFrameTotal()[int(input - XDelta)];
+		if (input >= FirstClickCount)
+			return ClickCountLastFrame(MouseButton(input - FirstClickCount));
 		return LastFrameState[input];
 	}
 
@@ -172,44 +173,83 @@ namespace libgameinput
 		}
 	};
 
-	struct MouseWheelInputProperties : InputProperties
+	struct MouseDeltaInputProperties : InputProperties
 	{
-		MouseWheelInputProperties(std::string_view name)
+		MouseDeltaInputProperties(std::string_view name)
 		{
 			Name = name;
+			Flags.unset(InputFlags::Digital);
+			Flags.set(InputFlags::ReturnsToNeutral);
+			Flags.set(InputFlags::Correlated);
+			DeadZoneMin = DeadZoneMax = 0;
 			MinValue = -INFINITY;
 			MaxValue = INFINITY;
 		}
 	};
 
-	std::optional<InputProperties> AllegroMouse::PropertiesOf(DeviceInputID input) const
+	struct MouseClickCountInputProperties : InputProperties
 	{
-		switch (input)
+		MouseClickCountInputProperties(MouseButton button)
 		{
-		case (int)MouseButton::Left:
-		case (int)MouseButton::Right:
-		case (int)MouseButton::Middle:
-			return MouseButtonInputProperties{ MouseButton(input) };
-		case (int)MouseButton::Button4:
-		case (int)MouseButton::Button5:
-			return ButtonInputProperties{ (std::string)magic_enum::enum_name((MouseButton)input) };
-		case Wheel0: /// wheel 0
-			return MouseWheelInputProperties{ "Vertical Wheel" };
-		case Wheel1: /// wheel 1
-			return MouseWheelInputProperties{ "Horizontal Wheel" };
-		case XAxis: /// x axis
-			return MouseAxisInputProperties{ "X Axis", std::numeric_limits<double>::max() };
-		case YAxis: /// y axis
-			return MouseAxisInputProperties{ "Y Axis", std::numeric_limits<double>::max() };
-		default:
-			ReportInvalidInput(input);
-			std::terminate();
+			Name = std::format("{} Click Count", magic_enum::enum_name(button));
+			Flags.unset(InputFlags::Digital);
+			Flags.set(InputFlags::ReturnsToNeutral);
+			Flags.set(InputFlags::Correlated);
+			DeadZoneMin = DeadZoneMax = MinValue = 0;
+			MaxValue = INFINITY;
+			StepSize = 1;
 		}
+	};
+
+	struct MouseWheelInputProperties : InputProperties
+	{
+		MouseWheelInputProperties(std::string_view name)
+		{
+			Name = name;
+			MinValue = -INFINITY;
+			MaxValue = INFINITY;
+		}
+	};
+
+	auto AllegroMouse::ValidInputs() const -> std::span<InputProperties const>
+	{
+		static const std::array<InputProperties, TotalInputs> input_properties = {
+			MouseButtonInputProperties{ MouseButton::Left },
+			MouseButtonInputProperties{ MouseButton::Right },
+			MouseButtonInputProperties{ MouseButton::Middle },
+			ButtonInputProperties{ magic_enum::enum_name(MouseButton::Button4) },
+			ButtonInputProperties{ magic_enum::enum_name(MouseButton::Button5) },
+			MouseWheelInputProperties{ "Vertical Wheel" },
+			MouseWheelInputProperties{ "Horizontal Wheel" },
+			MouseAxisInputProperties{ "X Axis", std::numeric_limits<double>::max() },
+			MouseAxisInputProperties{ "Y Axis", std::numeric_limits<double>::max() },
+			MouseAxisInputProperties{ "Global X Axis", std::numeric_limits<double>::max() },
+			MouseAxisInputProperties{ "Global Y Axis", std::numeric_limits<double>::max() },
+			MouseDeltaInputProperties{ "X Delta" },
+			MouseDeltaInputProperties{ "Y Delta" },
+			MouseClickCountInputProperties{ MouseButton::Left },
+			MouseClickCountInputProperties{ MouseButton::Right },
+			MouseClickCountInputProperties{ MouseButton::Middle },
+			MouseClickCountInputProperties{ MouseButton::Button4 },
+			MouseClickCountInputProperties{ MouseButton::Button5 },
+		};
+		return input_properties;
 	}
 
 	void AllegroMouse::ForceRefresh()
 	{
-		al_get_mouse_cursor_position();
+		ALLEGRO_MOUSE_STATE state;
+		al_get_mouse_state(&state);
+		MouseMoved(state.x, state.y);
+		for (unsigned button = 0; button < ButtonCount; ++button)
+			CurrentState[button] = (state.buttons >> button) & 1;
+
+		int global_x = 0, global_y = 0;
+		if (al_get_mouse_cursor_position(&global_x, &global_y))
+		{
+			CurrentState[GlobalXAxis] = global_x;
+			CurrentState[GlobalYAxis] = global_y;
+		}
 	}
 
 	void AllegroMouse::NewFrame()
@@ -217,6 +257,8 @@ namespace libgameinput
 		LastFrameState = CurrentState;
 		CurrentState[Wheel0] = 0;
 		CurrentState[Wheel1] = 0;
+		mMotion.NewFrame();
+		IMouseDevice::NewFrame();
 	}
 
 	void AllegroMouse::ShowCursor(bool show)
@@ -272,14 +314,16 @@ namespace libgameinput
 		CurrentState[Wheel0 + wheel] += delta;
 	}
 
-	void AllegroMouse::MouseButtonPressed(MouseButton button)
+	void AllegroMouse::MouseButtonPressed(MouseButton button, vec2 position, TimePoint time)
 	{
 		CurrentState[(unsigned)button] = 1;
+		RecordButtonPress(button, position, time);
 	}
 
 	void AllegroMouse::MouseButtonReleased(MouseButton button)
 	{
 		CurrentState[(unsigned)button] = 0;
+		RecordButtonRelease(button);
 	}
 
 	void AllegroMouse::MouseMoved(int x, int y)
@@ -288,6 +332,13 @@ namespace libgameinput
 		CurrentState[YAxis] = y;
 	}
 
+	void AllegroMouse::MouseMotion(int x, int y, double dx, double dy, TimePoint time)
+	{
+		CurrentState[XAxis] = x;
+		CurrentState[YAxis] = y;
+		mMotion.AddMotion({ dx, dy }, time);
+	}
+
 	void AllegroMouse::MouseEntered()
 	{
 	}
@@ -341,8 +392,13 @@ namespace libgameinput
 	{
 		mName = al_get_joystick_name(stick);
 		mSticks.resize(al_get_joystick_num_sticks(stick));
-		mButtons.resize(al_get_joystick_num_buttons(stick));
-		mNumInputs += (uint8_t)mButtons.size();
+		mNumButtons = (uint8_t)al_get_joystick_num_buttons(stick);
+		mNumInputs += mNumButtons;
+
+		/// Build the property table once per connected device; buttons first, then axes, in input order
+		for (size_t i = 0; i < mNumButtons; i++)
+			mInputProperties.push_back(ButtonInputProperties(al_get_joystick_button_name(stick, (int)i)));
+
 		for (size_t i = 0; i < mSticks.size(); i++)
 		{
 			mSticks[i].Name = al_get_joystick_stick_name(stick, (int)i);
@@ -350,13 +406,7 @@ namespace libgameinput
 			mNumInputs += mSticks[i].NumAxes;
 			mNumAxes += mSticks[i].NumAxes;
 			for (size_t a = 0; a < mSticks[i].NumAxes; a++)
-			{
-				mSticks[i].Axes[a] = StickAxisInputProperties(std::format("{} {}", mSticks[i].Name, al_get_joystick_axis_name(stick, (int)i, (int)a)));
-			}
-		}
-		for (size_t i = 0; i < mButtons.size(); i++)
-		{
-			mButtons[i] = ButtonInputProperties(al_get_joystick_button_name(stick, (int)i));
+				mInputProperties.push_back(StickAxisInputProperties(std::format("{} {}", mSticks[i].Name, al_get_joystick_axis_name(stick, (int)i, (int)a))));
 		}
 	}
 
@@ -377,13 +427,13 @@ namespace libgameinput
 	double AllegroGamepad::InputValue(DeviceInputID input) const
 	{
 		if (!IsInputValid(input)) return 0;
-		if (input < mButtons.size())
+		if (input < mNumButtons)
 		{
 			return CurrentState.Button[input];
 		}
 		else
 		{
-			auto stick_and_axis = CalculateStickAndAxis(input - (DeviceInputID)mButtons.size());
+			auto stick_and_axis = CalculateStickAndAxis(input - (DeviceInputID)mNumButtons);
 			return CurrentState.Stick[stick_and_axis.first].Axis[stick_and_axis.second];
 		}
 	}
@@ -396,13 +446,13 @@ namespace libgameinput
 	double AllegroGamepad::InputValueLastFrame(DeviceInputID input) const
 	{
 		if (!IsInputValid(input)) return 0;
-		if (input < mButtons.size())
+		if (input < mNumButtons)
 		{
 			return LastFrameState.Button[input];
 		}
 		else
 		{
-			auto stick_and_axis = CalculateStickAndAxis(input - (DeviceInputID)mButtons.size());
+			auto stick_and_axis = CalculateStickAndAxis(input - (DeviceInputID)mNumButtons);
 			return LastFrameState.Stick[stick_and_axis.first].Axis[stick_and_axis.second];
 		}
 	}
@@ -412,18 +462,9 @@ namespace libgameinput
 		return InputValueLastFrame(input) > 0.5;
 	}
 
-	std::optional<InputProperties> AllegroGamepad::PropertiesOf(DeviceInputID input) const
+	auto AllegroGamepad::ValidInputs() const -> std::span<InputProperties const>
 	{
-		if (!IsInputValid(input)) return {};
-		if (input < mButtons.size())
-		{
-			return mButtons[input];
-		}
-		else
-		{
-			auto stick_and_axis = CalculateStickAndAxis(input - (DeviceInputID)mButtons.size());
-			return mSticks[stick_and_axis.first].Axes[stick_and_axis.second];
-		}
+		return mInputProperties;
 	}
 
 	void AllegroGamepad::ForceRefresh()
@@ -456,12 +497,12 @@ namespace libgameinput
 
 	uint8_t AllegroGamepad::ButtonCount() const
 	{
-		return (uint8_t)mButtons.size();
+		return (uint8_t)mNumButtons;
 	}
 
 	bool AllegroGamepad::IsButtonPressed(uint8_t button_num) const
 	{
-		if (button_num < mButtons.size())
+		if (button_num < mNumButtons)
 			return CurrentState.Button[button_num] != 0;
 		return false;
 	}
@@ -488,7 +529,7 @@ namespace libgameinput
 		while (input > 0)
 		{
 			AssumingLess(stick, mSticks.size());
-			AssumingLess(axis, mSticks[stick].Axes.size());
+			AssumingLess(axis, 3);
 
 			axis++;
 			if (axis >= mSticks[stick].NumAxes)
@@ -503,7 +544,7 @@ namespace libgameinput
 
 	bool AllegroGamepad::WasButtonPressedLastFrame(uint8_t button_num) const
 	{
-		if (button_num < mButtons.size())
+		if (button_num < mNumButtons)
 			return LastFrameState.Button[button_num] != 0;
 		return false;
 	}
@@ -535,17 +576,66 @@ namespace libgameinput
 		mInputDevices.push_back(std::make_unique<AllegroMouse>(*this)); /// static constexpr InputDeviceIndex MouseDeviceID = 1;
 		mInputDevices.push_back(nullptr);
 		RefreshJoysticks();
+		InputDevicesChanged();
 
 		IInputSystem::Init();
 	}
 
+	void AllegroInput::ProcessEvents(ALLEGRO_EVENT_QUEUE* queue)
+	{
+		const auto mouse = static_cast<AllegroMouse*>(Mouse());
+		const auto resolution = mouse ? mouse->MotionPathResolution().count() : 0.0;
+
+		ALLEGRO_EVENT event{}, motion{};
+		bool has_motion = false;
+		double run_start = 0;
+		while (al_get_next_event(queue, &event))
+		{
+			if (event.type != ALLEGRO_EVENT_MOUSE_AXES)
+			{
+				/// Motion is flushed first, to keep it in order with button presses
+				if (std::exchange(has_motion, false))
+					ProcessEvent(motion);
+				ProcessEvent(event);
+				continue;
+			}
+
+			if (has_motion && event.mouse.display == motion.mouse.display && event.any.timestamp - run_start < resolution)
+			{
+				/// Positions and the timestamp come from the newest event, deltas add up
+				const auto dx = motion.mouse.dx + event.mouse.dx, dy = motion.mouse.dy + event.mouse.dy;
+				const auto dz = motion.mouse.dz + event.mouse.dz, dw = motion.mouse.dw + event.mouse.dw;
+				motion = event;
+				motion.mouse.dx = dx;
+				motion.mouse.dy = dy;
+				motion.mouse.dz = dz;
+				motion.mouse.dw = dw;
+				continue;
+			}
+
+			if (has_motion)
+				ProcessEvent(motion);
+			motion = event;
+			run_start = event.any.timestamp;
+			has_motion = true;
+		}
+		if (has_motion)
+			ProcessEvent(motion);
+	}
+
 	void AllegroInput::ProcessEvent(ALLEGRO_EVENT const& event)
 	{
-		const auto timestamp = std::chrono::time_point_cast<TimePoint::duration>(TimePoint{} + Seconds{ event.any.timestamp });
+		/// Allegro stamps events with `al_get_time()`; they are moved onto the clock of `TimePoint`, which tick sampling uses
+		const auto timestamp = std::chrono::high_resolution_clock::now() - std::chrono::duration_cast<TimePoint::duration>(Seconds{ al_get_time() - event.any.timestamp });
+		const auto gamepad_index = [&] {
+			const auto it = std::ranges::find_if(mInputDevices, [&](auto const& device) { return device.get() == mJoystickMap[event.joystick.id]; });
+			return InputDeviceIndex(it - mInputDevices.begin());
+		};
 		switch (event.type)
 		{
 		case ALLEGRO_EVENT_KEY_DOWN:
 			static_cast<AllegroKeyboard*>(Keyboard())->KeyPressed(event.keyboard.keycode);
+			ReportInputChange(KeyboardDeviceID, event.keyboard.keycode, 1, timestamp);
 			SetLastActiveDevice(Keyboard(), timestamp);
 			break;
 		case ALLEGRO_EVENT_KEY_CHAR:
@@ -553,19 +643,29 @@ namespace libgameinput
 			break;
 		case ALLEGRO_EVENT_KEY_UP:
 			static_cast<AllegroKeyboard*>(Keyboard())->KeyReleased(event.keyboard.keycode);
+			ReportInputChange(KeyboardDeviceID, event.keyboard.keycode, 0, timestamp);
 			SetLastActiveDevice(Keyboard(), timestamp);
 			break;
 		case ALLEGRO_EVENT_MOUSE_AXES:
-			static_cast<AllegroMouse*>(Mouse())->MouseWheelScrolled(event.mouse.dz, event.mouse.dw);
-			static_cast<AllegroMouse*>(Mouse())->MouseMoved(event.mouse.x, event.mouse.y);
-			SetLastActiveDevice(Mouse(), timestamp);
+		{
+			/// Only the parts that changed are applied; runs of these are merged by `ProcessEvents` before they get here
+			const auto mouse = static_cast<AllegroMouse*>(Mouse());
+			if (event.mouse.dz)
+				mouse->MouseWheelScrolled(float(event.mouse.dz), 0);
+			if (event.mouse.dw)
+				mouse->MouseWheelScrolled(float(event.mouse.dw), 1);
+			mouse->MouseMotion(event.mouse.x, event.mouse.y, event.mouse.dx, event.mouse.dy, timestamp);
+			SetLastActiveDevice(mouse, timestamp);
 			break;
+		}
 		case ALLEGRO_EVENT_MOUSE_BUTTON_DOWN:
-			static_cast<AllegroMouse*>(Mouse())->MouseButtonPressed(MouseButton(event.mouse.button - 1));
+			static_cast<AllegroMouse*>(Mouse())->MouseButtonPressed(MouseButton(event.mouse.button - 1), { event.mouse.x, event.mouse.y }, timestamp);
+			ReportInputChange(MouseDeviceID, event.mouse.button - 1, 1, timestamp);
 			SetLastActiveDevice(Mouse(), timestamp);
 			break;
 		case ALLEGRO_EVENT_MOUSE_BUTTON_UP:
 			static_cast<AllegroMouse*>(Mouse())->MouseButtonReleased(MouseButton(event.mouse.button - 1));
+			ReportInputChange(MouseDeviceID, event.mouse.button - 1, 0, timestamp);
 			SetLastActiveDevice(Mouse(), timestamp);
 			break;
 		case ALLEGRO_EVENT_MOUSE_ENTER_DISPLAY:
@@ -586,11 +686,13 @@ namespace libgameinput
 			Assuming(mJoystickMap.contains(event.joystick.id));
 			SetLastActiveDevice(mJoystickMap[event.joystick.id], timestamp);
 			dynamic_cast<AllegroGamepad*>(mLastActiveDevice)->CurrentState.Button[event.joystick.button] = 1;
+			ReportInputChange(gamepad_index(), event.joystick.button, 1, timestamp);
 			break;
 		case ALLEGRO_EVENT_JOYSTICK_BUTTON_UP:
 			Assuming(mJoystickMap.contains(event.joystick.id));
 			SetLastActiveDevice(mJoystickMap[event.joystick.id], timestamp);
 			dynamic_cast<AllegroGamepad*>(mLastActiveDevice)->CurrentState.Button[event.joystick.button] = 0;
+			ReportInputChange(gamepad_index(), event.joystick.button, 0, timestamp);
 			break;
 		case ALLEGRO_EVENT_JOYSTICK_CONFIGURATION:
 			RefreshJoysticks();
@@ -622,6 +724,8 @@ namespace libgameinput
 				else
 					mInputDevices.push_back(std::move(gamepad));
 			}
+
+			InputDevicesChanged();
 		}
 	}
 
@@ -16,6 +16,9 @@ namespace libgameinput
 
 		virtual void Init() override;
 		void ProcessEvent(ALLEGRO_EVENT const& event);
+		/// Processes every event in the queue. Runs of mouse motion events (high-rate mice send thousands per frame) are merged
+		/// before they reach the mouse; a run is only split where it spans more than the mouse's motion path resolution.
+		void ProcessEvents(ALLEGRO_EVENT_QUEUE* queue);
 		void RefreshJoysticks();
 		ALLEGRO_DISPLAY* ForDisplay() const;
 	};
@@ -29,7 +32,6 @@ namespace libgameinput
 		virtual bool IsInputPressed(DeviceInputID input) const override;
 		virtual double InputValueLastFrame(DeviceInputID input) const override;
 		virtual bool WasInputPressedLastFrame(DeviceInputID input) const override;
-		virtual std::optional<InputProperties> PropertiesOf(DeviceInputID input) const override;
 		virtual void ForceRefresh() override;
 		virtual void NewFrame() override;
 		virtual std::string_view StringPropertyValue(StringProperty property, std::string_view lang = {}) const override;
@@ -70,7 +72,7 @@ namespace libgameinput
 		virtual bool IsInputPressed(DeviceInputID input) const override;
 		virtual double InputValueLastFrame(DeviceInputID input) const override;
 		virtual bool WasInputPressedLastFrame(DeviceInputID input) const override;
-		virtual std::optional<InputProperties> PropertiesOf(DeviceInputID input) const override;
+		virtual auto ValidInputs() const -> std::span<InputProperties const> override;
 		virtual void ForceRefresh() override;
 		virtual void NewFrame() override;
 		virtual bool IsActive() const override;
@@ -87,6 +89,11 @@ namespace libgameinput
 
 		virtual DeviceInputID XAxisInputID() const override { return XAxis; }
 		virtual DeviceInputID YAxisInputID() const override { return YAxis; }
+		virtual DeviceInputID XDeltaInputID() const override { return XDelta; }
+		virtual DeviceInputID YDeltaInputID() const override { return YDelta; }
+		virtual auto MotionPath() const -> std::span<MouseMotionSample const> override { return mMotion.Path(); }
+		auto MotionPathResolution() const -> Seconds { return mMotion.PathResolution; }
+		virtual DeviceInputID ClickCountInputID(MouseButton button) const override { return FirstClickCount + DeviceInputID(button); }
 
 		virtual void ShowCursor(bool show) override;
 		virtual bool IsCursorVisible() const override;
@@ -100,9 +107,11 @@ namespace libgameinput
 
 
 		virtual void MouseWheelScrolled(float delta, unsigned wheel);
-		virtual void MouseButtonPressed(MouseButton button);
+		virtual void MouseButtonPressed(MouseButton button, vec2 position, TimePoint time);
 		virtual void MouseButtonReleased(MouseButton button);
 		virtual void MouseMoved(int x, int y);
+		/// Absorbs one motion event; cheap enough for thousands of events per frame
+		virtual void MouseMotion(int x, int y, double dx, double dy, TimePoint time);
 		virtual void MouseEntered();
 		virtual void MouseLeft();
 
@@ -120,14 +129,18 @@ namespace libgameinput
 		static constexpr DeviceInputID YAxis = ButtonCount + 3;
 		static constexpr DeviceInputID GlobalXAxis = ButtonCount + 4;
 		static constexpr DeviceInputID GlobalYAxis = ButtonCount + 5;
+		static constexpr DeviceInputID XDelta = ButtonCount + 6;
+		static constexpr DeviceInputID YDelta = ButtonCount + 7;
+		static constexpr DeviceInputID FirstClickCount = ButtonCount + 8;
 
 	private:
 
-		static constexpr uint64_t TotalInputs = ButtonCount + 2 /* wheels */ + 4 /* axes */;
+		static constexpr uint64_t TotalInputs = ButtonCount + 2 /* wheels */ + 4 /* axes */ + 2 /* deltas */ + ButtonCount /* click counts */;
 
 		std::array<double, TotalInputs> CurrentState{};
 		std::array<double, TotalInputs> LastFrameState{};
 		bool mCursorVisible = true;
+		MouseMotionAccumulator mMotion;
 	};
 
 	struct AllegroGamepad : IXboxGamepadDevice
@@ -139,7 +152,7 @@ namespace libgameinput
 		virtual bool IsInputPressed(DeviceInputID input) const override;
 		virtual double InputValueLastFrame(DeviceInputID input) const override;
 		virtual bool WasInputPressedLastFrame(DeviceInputID input) const override;
-		virtual std::optional<InputProperties> PropertiesOf(DeviceInputID input) const override;
+		virtual auto ValidInputs() const -> std::span<InputProperties const> override;
 		virtual void ForceRefresh() override;
 		virtual void NewFrame() override;
 		virtual bool IsActive() const override;
@@ -179,12 +192,12 @@ namespace libgameinput
 		{
 			const char* Name = "";
 			uint8_t NumAxes = 0;
-			std::array<InputProperties, 3> Axes;
 		};
 
 		const char* mName = "Generic Gamepad";
 		std::vector<JoystickStick> mSticks;
-		std::vector<InputProperties> mButtons;
+		std::vector<InputProperties> mInputProperties;
+		uint8_t mNumButtons = 0;
 		uint8_t mNumInputs = 0;
 		uint8_t mNumAxes = 0;
 